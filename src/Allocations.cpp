@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Allocations.cpp - counts heap allocations, for testing and benchmarks.      *
+ ******************************************************************************/
+
+// Only built when RPN_COUNT_ALLOCATIONS is defined, since it replaces the
+// global operator new and delete.
+#ifdef RPN_COUNT_ALLOCATIONS
+
+#include "rpn.h"
+#include <cstdlib>
+#include <new>
+
+static unsigned long allocations = 0;
+
+unsigned long RPN::allocationCount()
+{
+    return allocations;
+}
+
+void *operator new(size_t size)
+{
+    void *p = std::malloc(size ? size : 1);
+
+    if(!p)
+        throw std::bad_alloc();
+    ++allocations;
+
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) throw()
+{
+    std::free(p);
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Block.h - header for the Block class.                                       *
+ ******************************************************************************/
+
+#ifndef RPN_BLOCK_H
+#define RPN_BLOCK_H
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "typedefs.h"
+#include "Jit.h"
+#include "Operation.h"
+
+// computed gotos jump straight from one step to the next, rather than back
+// through a switch, which is most of the cost of a step.
+#if defined(__GNUC__) && !defined(RPN_NO_THREADED_CODE)
+#define RPN_THREADED_CODE
+#endif
+
+namespace RPN
+{
+    //! A run of literals and operators that can be run without touching the
+    //! stack, once it's known to hold enough numbers for every operator. The
+    //! operands are copied into registers once, the top value is kept in a
+    //! local variable while the steps run, and the results are copied back.
+    //! A block that's run often enough is compiled to machine code.
+    template <class T>
+    class BasicBlock
+    {
+    public:
+
+        //! The type of an operator of the block.
+        typedef BasicOperation<T> Operation;
+
+        //! How many times a block is interpreted before it's compiled.
+        static const size_t HOT = 64;
+
+        //! What a step does.
+        enum Code
+        {
+            Literal,
+            Unary,
+            Binary,
+            Ternary,
+            End
+        };
+
+        //! A single step: a number to push, or the function to apply.
+        struct Step
+        {
+            Code code;
+            union
+            {
+                T                            value;
+                typename Operation::Unary    unary;
+                typename Operation::Binary   binary;
+                typename Operation::Ternary  ternary;
+            };
+        };
+
+    private:
+
+        std::vector<Step>  steps;
+        size_t             need;
+        size_t             height;
+        size_t             depth;
+        mutable size_t     runs;
+        mutable NativeCode native;
+
+        //! Adds a step before the last, which always ends the block.
+        void Add(const Step& step)
+        {
+            Step end = steps.back();
+            steps.back() = step;
+            steps.push_back(end);
+        }
+
+    public:
+
+        //! Creates an empty block.
+        BasicBlock()
+            : steps(1), need(0), height(0), depth(0), runs(0),
+              native()
+        {
+            steps[0].code = End;
+        }
+
+        //! Adds a step that pushes a number.
+        void Push(T value)
+        {
+            Step step;
+            step.code = Literal;
+            step.value = value;
+            Add(step);
+
+            if(++height > depth)
+                depth = height;
+        }
+
+        //! Adds a step that applies an operator. If it has more operands than
+        //! the block has pushed, the rest must come from the stack.
+        void Apply(const Operation& op)
+        {
+            Step step;
+            unsigned arity = op.Arity();
+
+            if(height < arity)
+            {
+                need += arity - height;
+                depth += arity - height;
+                height = arity;
+            }
+
+            switch(arity)
+            {
+            case 1:
+                step.code = Unary;
+                step.unary = op.GetUnary();
+                break;
+            case 2:
+                step.code = Binary;
+                step.binary = op.GetBinary();
+                break;
+            default:
+                step.code = Ternary;
+                step.ternary = op.GetTernary();
+                break;
+            }
+
+            Add(step);
+            height -= arity - 1;
+        }
+
+        //! Returns how many numbers the block takes from the stack.
+        size_t Need() const { return need; }
+
+        //! Returns how many numbers the block leaves in their place.
+        size_t Results() const { return height; }
+
+        //! Returns how many registers running the block needs.
+        size_t Registers() const { return depth + 1; }
+
+        //! Returns the steps, the last of which ends the block.
+        const std::vector<Step>& Steps() const { return steps; }
+
+        //! Runs the block. The operands are in registers[1] onwards, and the
+        //! results are left there. registers[0] is scratch space, so that
+        //! pushing onto an empty block needn't be a special case.
+        void Run(T* registers) const
+        {
+            if(!native.Empty())
+                native(registers);
+            else if(runs < HOT && ++runs == HOT)
+                Tier(registers);
+            else
+                Interpret(registers);
+        }
+
+    private:
+
+        //! Compiles the block, then runs it both ways. The machine code is
+        //! only kept if it gives exactly the interpreter's results.
+        void Tier(T* registers) const
+        {
+            NativeCode code = NativeCode::Compile(*this);
+            std::vector<T> check(registers, registers + Registers());
+
+            Interpret(registers);
+            if(code.Empty())
+                return;
+
+            code(&check[0]);
+            if(!std::memcmp(&check[1], &registers[1], height * sizeof(T)))
+                native = code;
+        }
+
+        //! Runs the block by interpreting its steps.
+        void Interpret(T* registers) const
+        {
+            const Step* step = &steps[0];
+            T* sp = registers + need;
+            T tos = *sp;
+
+#ifdef RPN_THREADED_CODE
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define RPN_CASE(code) code
+#define RPN_NEXT       goto *labels[(++step)->code]
+            static const void* const labels[] =
+            {
+                &&Literal, &&Unary, &&Binary, &&Ternary, &&End
+            };
+
+            goto *labels[step->code];
+#else
+#define RPN_CASE(code) case code
+#define RPN_NEXT       ++step; continue
+            for(;;) switch(step->code)
+            {
+#endif
+            RPN_CASE(Literal):
+                *sp++ = tos;
+                tos = step->value;
+                RPN_NEXT;
+
+            RPN_CASE(Unary):
+                tos = step->unary(tos);
+                RPN_NEXT;
+
+            RPN_CASE(Binary):
+                --sp;
+                tos = step->binary(*sp, tos);
+                RPN_NEXT;
+
+            RPN_CASE(Ternary):
+                sp -= 2;
+                tos = step->ternary(sp[0], sp[1], tos);
+                RPN_NEXT;
+
+            RPN_CASE(End):
+                *sp = tos;
+                return;
+#ifdef RPN_THREADED_CODE
+#pragma GCC diagnostic pop
+#else
+            }
+#endif
+#undef RPN_CASE
+#undef RPN_NEXT
+        }
+    };
+}
+
+#endif
@@ -29,73 +29,540 @@
  ******************************************************************************/
 
 #include "rpn.h"
-#include <boost/tokenizer.hpp>
-#include <sstream>
-using namespace boost;
 using namespace std;
 using namespace RPN;
 
-void Calculator::Eval(string s)
+template <class T>
+const size_t BasicCalculator<T>::NO_SLOT;
+
+//! The arguments of a command that takes none.
+static const vector<string> EMPTY_ARGUMENTS;
+
+template <class T>
+typename BasicCalculator<T>::Result BasicCalculator<T>::Eval(const string& s)
+{
+    typename Programs::iterator found = programs.find(s);
+
+    if(!HasStack()) return Stopped;
+
+    // programs can't be forgotten while one is running, so a variable being
+    // unset waits until now to drop those that might have its value.
+    if(stale)
+    {
+        programs.clear();
+        stale = false;
+        found = programs.end();
+    }
+
+    // compile the line only the first time it's seen.
+    if(found == programs.end())
+    {
+        if(programs.size() >= MAX_PROGRAMS)
+            programs.clear();
+        found = programs.insert(make_pair(s, Compile(s))).first;
+    }
+
+    Run(found->second);
+    return IsRunning() ? Evaluated : Stopped;
+}
+
+template <class T>
+typename BasicCalculator<T>::Symbol&
+BasicCalculator<T>::Lookup(const string& name)
+{
+    const BuiltinCommand* commands;
+    const BuiltinOperator* operators;
+    const BuiltinVariable* variables;
+    const BuiltinVariable* variable;
+    size_t numCommands, numOperators, numVariables;
+    Symbol* found = symbols.Find(name);
+
+    if(found)
+        return *found;
+
+    // the first time a name is seen, find out what it stands for.
+    commands = builtinCommands(numCommands);
+    operators = builtinOperators(numOperators);
+    variables = builtinVariables(numVariables);
+
+    Symbol& symbol = symbols.Intern(name);
+    symbol.command = findBuiltin(commands, numCommands, name);
+    symbol.operation = findBuiltin(operators, numOperators, name);
+    variable = findBuiltin(variables, numVariables, name);
+
+    if(variable)
+    {
+        symbol.slot = slots.size();
+        slots.push_back(Slot(name, variable->value, true));
+    }
+
+    return symbol;
+}
+
+template <class T>
+size_t BasicCalculator<T>::SlotOf(Symbol& symbol, const string& name)
 {
-    typedef tokenizer< char_separator<char> > Tokens;
-    char_separator<char> sep(" \t\n");
-    Tokens tokens(s, sep);
+    if(symbol.slot == NO_SLOT)
+    {
+        symbol.slot = slots.size();
+        slots.push_back(Slot(name));
+    }
+
+    return symbol.slot;
+}
+
+// puts a block in front of each run of two or more literals and operators, so
+// that the run can be done at once when the stack allows it. the blocks are
+// added to blocks, and the instructions that run them refer to them there.
+template <class T>
+static vector<BasicInstruction<T> >
+addBlocks(const vector<BasicInstruction<T> >& program,
+          vector<BasicBlock<T> >& blocks)
+{
+    typedef BasicInstruction<T> Instruction;
+    vector<Instruction> threaded;
+    size_t i = 0, j;
+
+    threaded.reserve(program.size() + 1);
+
+    while(i < program.size())
+    {
+        BasicBlock<T> block;
+
+        for(j = i; j < program.size(); ++j)
+        {
+            const Instruction& ins = program[j];
 
-    if(!HasStack()) return;
+            if(ins.Code() == Instruction::PushLiteral)
+                block.Push(ins.Number());
+            else if(ins.Code() == Instruction::CallOperator)
+                block.Apply(ins.GetOperation());
+            else
+                break;
+        }
 
-    for(Tokens::iterator tok = tokens.begin();
-        tok != tokens.end() && status == Continue;
-        ++tok)
+        if(j - i > 1)
+        {
+            threaded.push_back(Instruction::Threaded(blocks.size(), j - i));
+            blocks.push_back(block);
+        }
+        else
+            j = i + 1;
+
+        threaded.insert(threaded.end(), program.begin() + i,
+                        program.begin() + j);
+        i = j;
+    }
+
+    return threaded;
+}
+
+template <class T>
+typename BasicCalculator<T>::Program
+BasicCalculator<T>::Compile(const string& s)
+{
+    Lexer lexer(s);
+    Token tok;
+    Instructions code;
+    Program program;
+
+    while(lexer.Next(tok))
     {
-        Commands::iterator  foundCommand   = commands.find(*tok);
-        Operators::iterator foundOperator  = operators.find(*tok);
-        Variables::iterator foundVariable  = variables.find(*tok);
-        Value val;
+        T val;
 
         // if the token is a number, push it.
-        if(istringstream(*tok) >> val)
-            CurrentStack().push_front(val);
+        if(parseNumber(tok.begin, tok.begin + tok.length, val))
+        {
+            code.push_back(Instruction::Literal(val));
+            continue;
+        }
+
+        string name = tok.Str();
+        Symbol& symbol = Lookup(name);
 
-        // if the token is a command, perform it.
-        else if(foundCommand != commands.end())
+        // if the token is a command, collect the tokens that will be its
+        // arguments. a command without enough arguments is never performed,
+        // and neither is anything after it.
+        if(symbol.command)
         {
-            const Command& command = foundCommand->second;
+            Command command(symbol.command->function, symbol.command->args);
             vector<string> args;
             args.reserve(command.NumArgs());
 
-            // collect a the tokens that will be the arguments to the command.
-            while(tok != tokens.end() && args.size() != command.NumArgs())
-                args.push_back(*++tok);
+            while(args.size() != command.NumArgs() && lexer.Next(tok))
+                args.push_back(tok.Str());
+
+            if(args.size() != command.NumArgs())
+                break;
+
+            if(args.empty())
+                code.push_back(Instruction::Cmd(symbol.command->name, command,
+                                                Instruction::NO_ARGUMENTS));
+            else
+            {
+                code.push_back(Instruction::Cmd(symbol.command->name, command,
+                                                program.arguments.size()));
+                program.arguments.push_back(args);
+            }
+        }
+
+        // whether an operator can be applied depends on the stack, so that's
+        // decided when the program is run.
+        else if(symbol.operation)
+        {
+            const BuiltinOperator& op = *symbol.operation;
+            Operation operation(op.arity, op.pure, op.unary, op.binary,
+                                op.ternary, op.kernel);
+            code.push_back(Instruction::Oper(op.name, operation,
+                                             SlotOf(symbol, name)));
+        }
+
+        // likewise for whether a variable is pushed or set.
+        else
+            code.push_back(Instruction::Var(SlotOf(symbol, name)));
+    }
+
+#ifdef RPN_STATS
+    // a block would run many tokens as one, so each is run by itself to be
+    // counted.
+    program.instructions = Optimize(code);
+    AddStatistics(program);
+#else
+    program.instructions = addBlocks(Optimize(code), program.blocks);
+#endif
+    return program;
+}
+
+#ifdef RPN_STATS
+template <class T>
+void BasicCalculator<T>::AddStatistics(Program& program)
+{
+    for(size_t i = 0; i < program.instructions.size(); ++i)
+    {
+        Instruction& ins = program.instructions[i];
 
-            // only perform a command if we can give it enough arguments.
-            if(args.size() == command.NumArgs())
-                command.Perform(*this, args);
+        switch(ins.Code())
+        {
+        case Instruction::PushLiteral:
+            ins.SetStatistic(statistics.Row("literal", ""));
+            break;
+
+        case Instruction::CallOperator:
+            ins.SetStatistic(statistics.Row("operator", ins.Name()));
+            break;
+
+        case Instruction::CallCommand:
+            ins.SetStatistic(statistics.Row("command", ins.Name()));
+            break;
+
+        default:
+            break;
         }
+    }
+}
+
+template <class T>
+size_t BasicCalculator<T>::VariableStatistic(size_t slot)
+{
+    const Slot& variable = slots[slot];
+    std::vector<size_t>& rows = variable.set ? loads : stores;
 
-        // if the token is an operator and that stack has at least two items,
-        // then perform that operator.
-        else if(foundOperator != operators.end() && StackSize() > 1)
+    if(rows.size() <= slot)
+        rows.resize(slots.size(), NO_SLOT);
+    if(rows[slot] == NO_SLOT)
+        rows[slot] = statistics.Row(variable.set ? "load" : "store",
+                                    variable.name);
+
+    return rows[slot];
+}
+#endif
+
+template <class T>
+void BasicCalculator<T>::Run(const Program& program)
+{
+    for(typename Instructions::const_iterator ins =
+            program.instructions.begin();
+        ins != program.instructions.end() && status == Continue;
+        ++ins)
+    {
+#ifdef RPN_STATS
+        unsigned long long start = timestamp();
+        size_t row = ins->Code() == Instruction::Variable ?
+                     VariableStatistic(ins->Slot()) : ins->Statistic();
+#endif
+
+        switch(ins->Code())
+        {
+        case Instruction::PushLiteral:
+            CurrentStack().push(ins->Number());
+            break;
+
+        case Instruction::CallCommand:
+            ins->GetCommand().Perform(*this,
+                ins->Arguments() == Instruction::NO_ARGUMENTS ? EMPTY_ARGUMENTS :
+                program.arguments[ins->Arguments()]);
+            break;
+
+        // if the stack has enough items, perform the operator; otherwise,
+        // treat it like a variable.
+        case Instruction::CallOperator:
         {
-            Value b = TopmostItem(); CurrentStack().pop_front();
-            Value a = TopmostItem(); CurrentStack().pop_front();
-            CurrentStack().push_front(foundOperator->second(a, b));
+            const Operation& operation = ins->GetOperation();
+            Stack& stack = CurrentStack();
+            const Stack& items = stack;
+            size_t n = stack.size();
+            unsigned arity = operation.Arity();
+            bool elementwise = false;
+
+            if(n < arity)
+            {
+#ifdef RPN_STATS
+                row = VariableStatistic(ins->Slot());
+#endif
+                LoadOrStore(ins->Slot());
+                break;
+            }
+
+            for(size_t i = n - arity; i < n && !elementwise; ++i)
+                elementwise = items[i].IsArray();
+
+            // arrays of different lengths can't be combined, which is treated
+            // like too few operands.
+            if(elementwise)
+            {
+                if(!ApplyElementwise(operation))
+                {
+#ifdef RPN_STATS
+                    row = VariableStatistic(ins->Slot());
+#endif
+                    LoadOrStore(ins->Slot());
+                }
+            }
+            else if(arity == 2)
+            {
+                T b = items[n - 1].Scalar(); stack.pop();
+                T a = items[n - 2].Scalar();
+                stack.top() = operation(a, b);
+            }
+            else if(arity == 1)
+                stack.top() = operation(items[n - 1].Scalar());
+            else
+            {
+                T c = items[n - 1].Scalar(); stack.pop();
+                T b = items[n - 2].Scalar(); stack.pop();
+                T a = items[n - 3].Scalar();
+                stack.top() = operation(a, b, c);
+            }
+            break;
+        }
+
+        case Instruction::Variable:
+            LoadOrStore(ins->Slot());
+            break;
+
+        // skip the block's instructions if it could be run by itself.
+        case Instruction::RunBlock:
+            if(RunBlock(program.blocks[ins->BlockIndex()]))
+                ins += ins->Length();
+            break;
         }
 
-        // if the token is a variable, push the variable onto the stack.
-        else if(foundVariable != variables.end())
-            CurrentStack().push_front(foundVariable->second);
+#ifdef RPN_STATS
+        statistics.Add(row, timestamp() - start);
+#endif
+    }
+}
+
+template <class T>
+bool BasicCalculator<T>::ApplyElementwise(const Operation& operation)
+{
+    Stack& stack = CurrentStack();
+    unsigned arity = operation.Arity();
+    size_t first = stack.size() - arity;
+    Item operands[3];
+    const T* data[3];
+    size_t steps[3];
+    size_t n = 0;
+    bool arrays = false;
+    Item result;
+    T* out;
+
+    // arrays of different lengths can't be combined, so leave them be. an
+    // empty array is a length like any other.
+    for(unsigned i = 0; i < arity; ++i)
+    {
+        operands[i] = stack[first + i];
+        if(!operands[i].IsArray())
+            continue;
+        if(arrays && operands[i].Size() != n)
+            return false;
+        arrays = true;
+        n = operands[i].Size();
+    }
+
+    for(unsigned i = 1; i < arity; ++i)
+        stack.pop();
+    stack.top() = Item();
+
+    // write over the first operand's elements if nothing else shares them.
+    if(operands[0].IsArray() && operands[0].Unique())
+    {
+        out = operands[0].MutableData();
+        result = operands[0];
+    }
+    else
+    {
+        result = Item::Array(n);
+        out = result.MutableData();
+    }
+
+    // a single value is used for every element, so don't step through it.
+    for(unsigned i = 0; i < arity; ++i)
+    {
+        data[i] = operands[i].Data();
+        steps[i] = operands[i].IsArray() ? 1 : 0;
+    }
+
+    operation(data, steps, out, n);
+    stack.top() = result;
+    return true;
+}
+
+template <class T>
+bool BasicCalculator<T>::RunBlock(const Block& block)
+{
+    Stack& stack = CurrentStack();
+    const Stack& items = stack;
+    size_t n = stack.size();
+    size_t need = block.Need();
+    size_t results = block.Results();
+    size_t first = n - need;
+    size_t i;
+    T* values;
+
+    // the operands must all be numbers, or some operator would act as a
+    // variable or on arrays.
+    if(n < need)
+        return false;
+    for(i = first; i < n; ++i)
+        if(items[i].IsArray())
+            return false;
+
+    // the registers are only checked once per block, not once per push.
+    if(registers.size() < block.Registers())
+        registers.resize(block.Registers());
+    values = &registers[1];
+
+    for(i = 0; i < need; ++i)
+        values[i] = items[first + i].Scalar();
+
+    block.Run(&registers[0]);
+
+    // replace the operands with the results.
+    for(i = 0; i < results && i < need; ++i)
+        stack[first + i] = values[i];
+    for(; i < results; ++i)
+        stack.push(values[i]);
+    for(; i < need; ++i)
+        stack.pop();
+
+    return true;
+}
+
+template <class T>
+void BasicCalculator<T>::LoadOrStore(size_t n)
+{
+    Slot& slot = slots[n];
+
+    // if the variable is set, push it onto the stack; otherwise, set it to the
+    // top item.
+    if(slot.set)
+        CurrentStack().push(slot.value);
+    else
+    {
+        slot.value = TopmostItem();
+        slot.set = true;
+        Changed(n);
+    }
+}
+
+template <class T>
+void BasicCalculator<T>::Changed(size_t n)
+{
+    if(!slots[n].changed)
+    {
+        slots[n].changed = true;
+        changed.push_back(n);
+    }
+}
+
+template <class T>
+void BasicCalculator<T>::Reset()
+{
+    const BuiltinVariable* variables;
+    const BuiltinVariable* variable;
+    size_t count;
+
+    // the newest stack is kept, emptied, so that its chunks are reused.
+    if(HasStack())
+        history.erase(++history.begin(), history.end());
+    else
+        history = defaultHistory();
+    ClearStack();
 
-        // otherwise, if the stack has at least one item, set a new variable 
-        // whose name is the token and value is the top item.
-        else variables[*tok] = TopmostItem();
+    // only the variables that were set or unset need to be put back. the
+    // compiled lines may have folded their values, so they're dropped too.
+    if(!changed.empty())
+        stale = true;
+
+    variables = builtinVariables(count);
+    for(size_t i = 0; i < changed.size(); ++i)
+    {
+        Slot& slot = slots[changed[i]];
+
+        variable = findBuiltin(variables, count, slot.name);
+        slot.value = variable ? Item(variable->value) : Item();
+        slot.set = variable != NULL;
+        slot.changed = false;
     }
+    changed.clear();
+
+    status = Continue;
+}
+
+template <class T>
+const typename BasicCalculator<T>::Item*
+BasicCalculator<T>::Variable(const string& name)
+{
+    const BuiltinVariable* variables;
+    size_t numVariables;
+    Symbol* symbol = symbols.Find(name);
+
+    // only a predefined variable is worth interning a name for; any other
+    // name the calculator hasn't seen can't be set.
+    if(!symbol)
+    {
+        variables = builtinVariables(numVariables);
+        if(!findBuiltin(variables, numVariables, name))
+            return NULL;
+        symbol = &Lookup(name);
+    }
+
+    if(symbol->slot == NO_SLOT || !slots[symbol->slot].set)
+        return NULL;
+    return &slots[symbol->slot].value;
 }
 
 // displays the top item of the stack if there is one.
 // I tried to write this as a friend operator<<(), but I got errors for
 // accessing private data, which is what friend functions are supposed to be
 // able to do!
-void Calculator::Display() const
+template <class T>
+void BasicCalculator<T>::Display() const
 {
-    Print(TopmostItem());
+    PrintItem(TopmostItem(), Print);
 }
+
+#define INSTANTIATE(T) \
+    template class RPN::BasicCalculator<T>;
+RPN_FOR_EACH_TYPE(INSTANTIATE)
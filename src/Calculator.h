@@ -31,15 +31,133 @@
 #ifndef RPN_CALCULATOR_H
 #define RPN_CALCULATOR_H
 
+#include <list>
+#include <map>
 #include <string>
 #include <vector>
 #include "typedefs.h"
+#include "Block.h"
+#include "Command.h"
+#include "Instruction.h"
+#include "Item.h"
+#include "Operation.h"
+#include "Statistics.h"
+#include "Stack.h"
+#include "SymbolTable.h"
 
 namespace RPN
 {
-    //! The main class for the program.
-    class Calculator
+    //! The main class for the program, operating on values of type T.
+    //! Calculators share their built-in tables, so each thread can cheaply
+    //! have its own.
+    template <class T>
+    class BasicCalculator
     {
+    public:
+
+        //! The type of an item of the stack or a variable.
+        typedef BasicItem<T>                     Item;
+        //! The type of the stack.
+        typedef BasicStack<T>                    Stack;
+        //! The type of a command.
+        typedef BasicCommand<T>                  Command;
+        //! The type of an operator.
+        typedef BasicOperation<T>                Operation;
+        //! The type of a run of literals and operators.
+        typedef BasicBlock<T>                    Block;
+        //! The type of a step of a compiled program.
+        typedef BasicInstruction<T>              Instruction;
+        //! The type of the history stack used by the calculator.
+        typedef std::list<Stack>                 History;
+        //! The type of a list of instructions.
+        typedef std::vector<Instruction>         Instructions;
+
+        //! A compiled line of input. The blocks that its RunBlock
+        //! instructions run, and the arguments of its commands, are kept
+        //! apart from them, so that instructions stay small and making one
+        //! doesn't allocate.
+        struct Program
+        {
+            Instructions                          instructions;
+            std::vector<Block>                    blocks;
+            std::vector<std::vector<std::string> > arguments;
+
+            Program() : instructions(), blocks(), arguments() {}
+        };
+
+        //! The type of the cache of compiled programs, keyed by their source.
+        typedef std::map<std::string, Program>   Programs;
+
+        //! A built-in command. The tables of these are plain arrays sorted
+        //! by name, so they're laid out by the compiler and cost nothing at
+        //! run time.
+        struct BuiltinCommand
+        {
+            const char*                  name;
+            typename Command::CommandPtr function;
+            unsigned                     args;
+        };
+
+        //! A built-in operator; see BasicOperation.
+        struct BuiltinOperator
+        {
+            const char*                 name;
+            unsigned                    arity;
+            bool                        pure;
+            typename Operation::Unary   unary;
+            typename Operation::Binary  binary;
+            typename Operation::Ternary ternary;
+            typename Operation::Kernel  kernel;
+            //! The name of the function in Operators.h, for generated code.
+            const char*                 function;
+        };
+
+        //! A predefined variable.
+        struct BuiltinVariable
+        {
+            const char* name;
+            T           value;
+        };
+
+        //! Marks a symbol that has no variable slot yet.
+        static const size_t NO_SLOT = (size_t)-1;
+
+        //! What a name stands for. Anything but a command can also be a
+        //! variable, since an operator without enough operands loads or
+        //! stores the variable of its name.
+        struct Symbol
+        {
+            const BuiltinCommand*  command;
+            const BuiltinOperator* operation;
+            size_t                 slot;
+
+            Symbol() : command(NULL), operation(NULL), slot(NO_SLOT) {}
+        };
+
+        //! A variable, which exists once it has been set.
+        struct Slot
+        {
+            std::string name;
+            Item        value;
+            bool        set;
+            //! Whether the variable is in the list of those to put back by
+            //! Reset().
+            bool        changed;
+
+            Slot(const std::string& name = "", const Item& value = 0,
+                 bool set = false)
+                : name(name), value(value), set(set), changed(false)
+            {
+            }
+        };
+
+        //! The type of the table of every name the calculator has seen.
+        typedef SymbolTable<Symbol>              Symbols;
+        //! The type of the variables, indexed by slot.
+        typedef std::vector<Slot>                Slots;
+
+    private:
+
         //! Holds the calculator's status, i.e. whether it's running or not.
         enum Status
         {
@@ -47,48 +165,90 @@ namespace RPN
             Stop
         };
 
-        Commands  commands;
-        HelpItems helpItems;
-        History   history;
-        Operators operators;
-        Status    status;
-        Variables variables;
+        History          history;
+        Programs         programs;
+        std::vector<T>   registers;
+        Slots            slots;
+        //! The slots of the variables set or unset since the last Reset().
+        std::vector<size_t> changed;
+        bool             stale;
+        Status           status;
+        Symbols          symbols;
+#ifdef RPN_STATS
+        Statistics       statistics;
+        //! The rows of the statistics of loading and storing each variable.
+        std::vector<size_t> loads, stores;
+#endif
 
         //! The command to duplicate the top item of the stack.
-        void dup                   (std::vector<std::string>&);
+        void dup                   (const std::vector<std::string>&);
         //! The command to exit the calculator.
-        void exit                  (std::vector<std::string>&);
+        void exit                  (const std::vector<std::string>&);
+        //! Packs the top n items into an array, where n is the topmost item.
+        void pack                  (const std::vector<std::string>&);
         //! Pops the topmost item from the stack.
-        void pop                   (std::vector<std::string>&);
+        void pop                   (const std::vector<std::string>&);
         //! Removes the top stack as long as there will be at least one left.
-        void popHistory            (std::vector<std::string>&);
+        void popHistory            (const std::vector<std::string>&);
         //! The command to print the help list.
-        void printHelp             (std::vector<std::string>&);
+        void printHelp             (const std::vector<std::string>&);
         //! Copies the top stack and pushes it onto the history.
-        void pushHistory           (std::vector<std::string>&);
+        void pushHistory           (const std::vector<std::string>&);
         //! The generic method to print the history.
-        void printHistoryGeneric   (void (*)(Value));
+        void printHistoryGeneric   (void (*)(T));
         //! The command to print the history.
-        void printHistory          (std::vector<std::string>&);
+        void printHistory          (const std::vector<std::string>&);
         //! The command to print the history in detail.
-        void printHistoryDetailed(std::vector<std::string>&);
+        void printHistoryDetailed(const std::vector<std::string>&);
         //! The command to print the stack.
-        void printStack            (std::vector<std::string>&);
+        void printStack            (const std::vector<std::string>&);
         //! The command to print the stack in detail.
-        void printStackDetailed    (std::vector<std::string>&);
+        void printStackDetailed    (const std::vector<std::string>&);
         //! The generic method to print the variables.
-        void printVariablesGeneric (void (*)(Value));
+        void printVariablesGeneric (void (*)(T));
         //! The command to print the variables.
-        void printVariables        (std::vector<std::string>&);
+        void printVariables        (const std::vector<std::string>&);
         //! The command to print the variables in detail.
-        void printVariablesDetailed(std::vector<std::string>&);
-        void printVersion          (std::vector<std::string>&);
-        //! Pops the top item, then pushes its square root.
-        void sqrtTop               (std::vector<std::string>&);
+        void printVariablesDetailed(const std::vector<std::string>&);
+        void printVersion          (const std::vector<std::string>&);
+        //! Prints the statistics of what the calculator has run.
+        void printStatistics       (const std::vector<std::string>&);
         //! Swaps the top two items of the stack.
-        void swap                  (std::vector<std::string>&);
+        void swap                  (const std::vector<std::string>&);
+        //! Replaces an array on top of the stack with its elements.
+        void unpack                (const std::vector<std::string>&);
         //! Unsets a previously set variable.
-        void unset                 (std::vector<std::string>&);
+        void unset                 (const std::vector<std::string>&);
+
+        //! Returns the symbol of a name, adding it to the table first if it's
+        //! new. The reference is only good until the next name is added.
+        Symbol& Lookup(const std::string& name);
+        //! Returns the slot of a symbol's variable, giving it one if needed.
+        size_t SlotOf(Symbol& symbol, const std::string& name);
+        //! Turns a line of input into a program.
+        Program Compile(const std::string& input);
+        //! Returns a faster program that does the same as a compiled one.
+        Instructions Optimize(const Instructions& program);
+#ifdef RPN_STATS
+        //! Gives each instruction of a program its row of the statistics.
+        void AddStatistics(Program& program);
+        //! Returns the row of the statistics of loading or storing a
+        //! variable, whichever LoadOrStore() would do now.
+        size_t VariableStatistic(size_t slot);
+#endif
+        //! Runs a compiled program.
+        void Run(const Program& program);
+        //! Runs a block if the stack holds enough numbers for it, returning
+        //! false if it doesn't.
+        bool RunBlock(const Block& block);
+        //! Pushes a variable if it's set, otherwise sets it to the top item.
+        void LoadOrStore(size_t slot);
+        //! Remembers that a variable was set or unset, for Reset().
+        void Changed(size_t slot);
+        //! Applies an operator to the top items of the stack, at least one of
+        //! which is an array. Returns false, leaving the items, if they are
+        //! arrays of different lengths.
+        bool ApplyElementwise(const Operation& operation);
 
         //! Returns true if there is at least one stack.
         bool HasStack() const { return history.size() != 0; }
@@ -97,39 +257,93 @@ namespace RPN
         Stack& CurrentStack() { return history.front(); }
         const Stack& CurrentStack() const { return history.front(); }
 
-        //! Returns the current stack's size.
-        size_t StackSize() const
-        {
-            return HasStack() ? CurrentStack().size() : 0;
-        }
+    public:
 
-        //! Returns the topmost item of the current stack.
-        Value TopmostItem() const
+        //! What evaluating a line did.
+        enum Result
         {
-            return HasStack() && StackSize() > 0 ? CurrentStack().front() : 0;
-        }
-
-    public:
+            //! The line was run and the calculator is still running.
+            Evaluated,
+            //! The calculator has stopped, because of the line or an earlier
+            //! one.
+            Stopped
+        };
 
         //! The default and only constructor.
-        Calculator()
-            : commands  (defaultCommands()),
-              helpItems (defaultHelpItems()),
-              history   (defaultHistory()),
-              operators (defaultOperators()),
+        BasicCalculator()
+            : history   (defaultHistory()),
+              programs  (),
+              registers (),
+              slots     (),
+              changed   (),
+              stale     (false),
               status    (Continue),
-              variables (defaultVariables())
+              symbols   ()
+#ifdef RPN_STATS
+              , statistics(), loads(), stores()
+#endif
         {
         }
 
         //! Evaluates a string.
-        void Eval(std::string input);
+        Result Eval(const std::string& input);
 
         //! Returns true if the calculator is running.
         bool IsRunning() const { return status == Continue; }
 
-        //! Returns a map of the default commands.
-        Commands defaultCommands();
+        //! Returns the built-in commands, sorted by name, and their number.
+        static const BuiltinCommand* builtinCommands(size_t& count);
+        //! Returns the built-in operators, sorted by name, and their number.
+        static const BuiltinOperator* builtinOperators(size_t& count);
+        //! Returns the operators the optimizer puts in place of built-in
+        //! ones, sorted by name, and their number.
+        static const BuiltinOperator* derivedOperators(size_t& count);
+        //! Returns the predefined variables, sorted by name, and their number.
+        static const BuiltinVariable* builtinVariables(size_t& count);
+        //! Returns a default, empty History stack.
+        static History defaultHistory();
+
+        //! Empties the current stack.
+        void ClearStack()
+        {
+            if(HasStack())
+                CurrentStack().clear();
+        }
+
+        //! Puts the calculator back the way it was made, with an empty stack,
+        //! no history, only the predefined variables, and running. Compiled
+        //! lines are kept, as are the stack's chunks, unless a variable they
+        //! might have folded is put back.
+        void Reset();
+
+        //! Returns the current stack's size.
+        size_t StackSize() const
+        {
+            return HasStack() ? CurrentStack().size() : 0;
+        }
+
+        //! Returns the item depth places below the top of the current stack,
+        //! which must be less than StackSize().
+        const Item& ItemAt(size_t depth) const
+        {
+            return CurrentStack()[StackSize() - 1 - depth];
+        }
+
+        //! Returns the value of a variable, or NULL if it isn't set. Names
+        //! the calculator hasn't seen aren't added to it. The pointer is only
+        //! good until the next line is evaluated.
+        const Item* Variable(const std::string& name);
+
+#ifdef RPN_STATS
+        //! Returns the statistics of what the calculator has run.
+        const Statistics& GetStatistics() const { return statistics; }
+
+#endif
+        //! Returns the topmost item of the current stack.
+        Item TopmostItem() const
+        {
+            return HasStack() && StackSize() > 0 ? CurrentStack().top() : 0;
+        }
 
         //! Displays the top item of the stack.
         void Display() const;
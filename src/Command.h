@@ -31,14 +31,26 @@
 #ifndef RPN_COMMAND_H
 #define RPN_COMMAND_H
 
+#include <string>
+#include <vector>
 #include "typedefs.h"
 
 namespace RPN
 {
     //! Holds information on a command, such as what its function is and how
     //! many arguments it takes.
-    class Command
+    template <class T>
+    class BasicCommand
     {
+    public:
+
+        //! The type of a command member function. All commands must be
+        //! members of the calculator class.
+        typedef void (BasicCalculator<T>::*CommandPtr)(
+            const std::vector<std::string>&);
+
+    private:
+
         CommandPtr command_ptr;
         unsigned num_args;
 
@@ -46,7 +58,7 @@ namespace RPN
 
         //! Constructs a command with a function pointer and number of
         //arguments.
-        Command(CommandPtr command_ptr = NULL, unsigned int num_args = 0)
+        BasicCommand(CommandPtr command_ptr = NULL, unsigned int num_args = 0)
             : command_ptr(command_ptr), num_args(num_args)
         {
         }
@@ -55,7 +67,8 @@ namespace RPN
         unsigned NumArgs() const { return num_args; }
 
         //! Performs the command on a calculator with the given functions.
-        void Perform(Calculator& calc, std::vector<std::string> args) const
+        void Perform(BasicCalculator<T>& calc,
+                     const std::vector<std::string>& args) const
         {
             if(command_ptr)
                 CALL_MEMBER_FN(calc, command_ptr)(args);
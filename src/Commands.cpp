@@ -30,140 +30,237 @@
 
 #include "rpn.h"
 #include <boost/foreach.hpp>
+#include <algorithm>
 #include <cmath>
 using namespace std;
 using namespace RPN;
 
 #ifndef DOXYGEN_SKIP
 
+// prints a stack from the top down.
 template <class T>
-static void printAnything(T t)
+static void printStackItems(const BasicStack<T>& stack, void (*printer)(T))
 {
-    Print(t);
+    Print("[ ");
+    for(size_t i = stack.size(); i-- > 0;)
+    {
+        PrintItem(stack[i], printer);
+        Print(", ");
+    }
+    Print(']');
 }
 
-template <class T>
-static void printAnythingDetailed(T t)
+template <class Slot>
+static bool slotBefore(const Slot* a, const Slot* b)
 {
-    PrintDetailed(t);
+    return a->name < b->name;
 }
 
-template <class T>
-static void printAnyList(list<T>& l, void (*printer)(T))
+#ifdef RPN_STATS
+// the tokens that took longest come first.
+static bool statisticBefore(const Statistic* a, const Statistic* b)
 {
-    Print("[ ");
-    BOOST_FOREACH(T& item, l)
-    {
-        printer(item);
-        Print(", ");
-    }
-    Print(']');
+    return a->time > b->time;
 }
+#endif
 
-static void printValue(Value v)
+template <class T>
+static void printValue(T v)
 {
-    printAnything(v);
+    PrintShortest(v);
 }
 
-static void printValueDetailed(Value v)
+template <class T>
+static void printValueDetailed(T v)
 {
-    printAnythingDetailed(v);
+    PrintDetailed(v);
 }
 
-void Calculator::dup(vector<string>&)
+template <class T>
+void BasicCalculator<T>::dup(const vector<string>&)
 {
     if(HasStack() && StackSize() > 0)
     {
         Stack& stack(CurrentStack());
-        stack.push_front(stack.front());
+        stack.push(stack.top());
     }
 }
 
-void Calculator::exit(vector<string>&)
+template <class T>
+void BasicCalculator<T>::exit(const vector<string>&)
 {
     status = Stop;
 }
 
-void Calculator::pop(vector<string>&)
+template <class T>
+void BasicCalculator<T>::pack(const vector<string>&)
+{
+    size_t n, size = 0, i;
+    T* out;
+
+    if(!HasStack() || StackSize() == 0 || CurrentStack().top().IsArray())
+        return;
+
+    // the count must be a whole number of items below it.
+    Stack& stack = CurrentStack();
+    const Stack& items = stack;
+    T count = items.top().Scalar();
+    if(!(count >= 0 && count < stack.size() && count == (size_t)count))
+        return;
+    n = (size_t)count;
+    stack.pop();
+
+    // arrays among the items are joined together.
+    for(i = stack.size() - n; i < stack.size(); ++i)
+        size += items[i].Size();
+
+    Item array(Item::Array(size));
+    out = array.MutableData();
+    for(i = stack.size() - n; i < stack.size(); ++i)
+    {
+        copy(items[i].Data(), items[i].Data() + items[i].Size(), out);
+        out += items[i].Size();
+    }
+
+    for(i = 0; i < n; ++i)
+        stack.pop();
+    stack.push(array);
+}
+
+template <class T>
+void BasicCalculator<T>::pop(const vector<string>&)
 {
     if(HasStack() && StackSize() > 0)
-        CurrentStack().pop_front();
+        CurrentStack().pop();
 }
 
-void Calculator::popHistory(vector<string>&)
+template <class T>
+void BasicCalculator<T>::popHistory(const vector<string>&)
 {
     if(history.size() > 1)
         history.pop_front();
 }
 
-void Calculator::printHelp(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printHelp(const vector<string>&)
 {
-    printHelpItems(helpItems);
+    size_t count;
+    const HelpItem* items = defaultHelpItems(count);
+
+    printHelpItems(items, count);
 }
 
-void Calculator::printHistoryGeneric(void (*printer)(Value))
+template <class T>
+void BasicCalculator<T>::printHistoryGeneric(void (*printer)(T))
 {
     Print('[');
     BOOST_FOREACH(Stack& item, history)
     {
-        printAnyList(item, printer);
+        printStackItems(item, printer);
         Print(", ");
     }
     Print("]\n");
 }
 
-void Calculator::printHistory(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printHistory(const vector<string>&)
 {
-    printHistoryGeneric(printValue);
+    printHistoryGeneric(printValue<T>);
 }
 
-void Calculator::printHistoryDetailed(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printHistoryDetailed(const vector<string>&)
 {
-    printHistoryGeneric(printValueDetailed);
+    printHistoryGeneric(printValueDetailed<T>);
 }
 
-void Calculator::printStack(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printStack(const vector<string>&)
 {
     if(HasStack())
     {
-        printAnyList(CurrentStack(), printValue);
+        printStackItems(CurrentStack(), printValue<T>);
         Print('\n');
     }
 }
 
-void Calculator::printStackDetailed(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printStackDetailed(const vector<string>&)
 {
     if(HasStack())
     {
-        printAnyList(CurrentStack(), printValueDetailed);
+        printStackItems(CurrentStack(), printValueDetailed<T>);
         Print('\n');
     }
 }
 
-void Calculator::printVariablesGeneric(void (*printer)(Value))
+template <class T>
+void BasicCalculator<T>::printVariablesGeneric(void (*printer)(T))
 {
+    vector<const Slot*> set;
+    const BuiltinVariable* builtins;
+    size_t count, i;
+
+    // predefined variables only get a slot once they're used, so give the
+    // rest one now. slots are in the order the names were first seen, so
+    // sort them.
+    builtins = builtinVariables(count);
+    for(i = 0; i < count; ++i)
+        Lookup(builtins[i].name);
+    BOOST_FOREACH(const Slot& slot, slots)
+        if(slot.set)
+            set.push_back(&slot);
+    sort(set.begin(), set.end(), slotBefore<Slot>);
+
     Print("[ ");
-    BOOST_FOREACH(Variables::value_type& v, variables)
+    BOOST_FOREACH(const Slot* slot, set)
     {
-        Print(v.first);
+        Print(slot->name);
         Print(" = ");
-        printer(v.second);
+        PrintItem(slot->value, printer);
         Print(", ");
     }
     Print("]\n");
 }
 
-void Calculator::printVariables(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printVariables(const vector<string>&)
 {
-    printVariablesGeneric(printValue);
+    printVariablesGeneric(printValue<T>);
 }
 
-void Calculator::printVariablesDetailed(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printVariablesDetailed(const vector<string>&)
 {
-    printVariablesGeneric(printValueDetailed);
+    printVariablesGeneric(printValueDetailed<T>);
 }
 
-void Calculator::printVersion(vector<string>&)
+template <class T>
+void BasicCalculator<T>::printStatistics(const vector<string>&)
+{
+#ifdef RPN_STATS
+    const vector<Statistic>& rows = statistics.Rows();
+    vector<const Statistic*> sorted;
+
+    // a token that was compiled but hasn't run yet has nothing to show.
+    for(size_t i = 0; i < rows.size(); ++i)
+        if(rows[i].count)
+            sorted.push_back(&rows[i]);
+    sort(sorted.begin(), sorted.end(), statisticBefore);
+
+    Port::Print("%-8s %-16s %12s %16s %12s\n", "kind", "name", "count",
+                Statistics::Unit(), "each");
+    BOOST_FOREACH(const Statistic* row, sorted)
+        Port::Print("%-8s %-16s %12lu %16llu %12.1f\n", row->kind,
+                    row->name.c_str(), row->count, row->time,
+                    (double)row->time / row->count);
+#else
+    Print("rpn was built without RPN_STATS, so nothing has been counted.\n");
+#endif
+}
+
+template <class T>
+void BasicCalculator<T>::printVersion(const vector<string>&)
 {
     Port::Print("RPN %i.%i.%i.%i", VERSION_MAJOR, VERSION_MINOR,
                                    VERSION_REVIS, VERSION_BUILD);
@@ -178,69 +275,88 @@ void Calculator::printVersion(vector<string>&)
     Print("\nBy Sam Fredrickson <kinghajj@gmail.com>\n");
 }
 
-void Calculator::pushHistory(vector<string>&)
+template <class T>
+void BasicCalculator<T>::pushHistory(const vector<string>&)
 {
     if(HasStack())
         history.push_front(CurrentStack());
 }
 
-void Calculator::sqrtTop(vector<string>&)
+template <class T>
+void BasicCalculator<T>::swap(const vector<string>&)
 {
-    if(HasStack() && StackSize() > 0)
+    if(HasStack() && StackSize() > 1)
     {
         Stack& stack = CurrentStack();
-        Value top = stack.front();
-        stack.pop_front();
-#ifdef RPN_DOUBLE
-        stack.push_front(sqrt(top));
-#elif  RPN_LONG_DOUBLE
-        stack.push_front(sqrtl(top));
-#endif
+        size_t n = stack.size();
+        std::swap(stack[n - 1], stack[n - 2]);
     }
 }
 
-void Calculator::swap(vector<string>&)
+template <class T>
+void BasicCalculator<T>::unpack(const vector<string>&)
 {
-    if(HasStack() && StackSize() > 1)
+    if(HasStack() && StackSize() > 0 && CurrentStack().top().IsArray())
     {
         Stack& stack = CurrentStack();
-        Value a, b;
-        a = stack.front();
-        stack.pop_front();
-        b = stack.front();
-        stack.pop_front();
-        stack.push_front(a);
-        stack.push_front(b);
+        Item array = stack.top();
+        const T* values = array.Data();
+
+        stack.pop();
+        for(size_t i = 0; i < array.Size(); ++i)
+            stack.push(values[i]);
     }
 }
 
-void Calculator::unset(vector<string>& args)
+template <class T>
+void BasicCalculator<T>::unset(const vector<string>& args)
 {
-    variables.erase(args.front());
+    Symbol& symbol = Lookup(args.front());
+
+    if(symbol.slot != NO_SLOT)
+    {
+        slots[symbol.slot].set = false;
+        slots[symbol.slot].value = Item();
+        Changed(symbol.slot);
+        stale = true;
+    }
 }
 
 #endif
 
-Commands Calculator::defaultCommands()
-{
-    Commands ret;
-
-    ret["dup"]   = Command(&Calculator::dup);
-    ret["help"]  = Command(&Calculator::printHelp);
-    ret["pop"]   = Command(&Calculator::pop);
-    ret["poph"]  = Command(&Calculator::popHistory);
-    ret["ph"]    = Command(&Calculator::printHistory);
-    ret["phd"]   = Command(&Calculator::printHistoryDetailed);
-    ret["ps"]    = Command(&Calculator::printStack);
-    ret["psd"]   = Command(&Calculator::printStackDetailed);
-    ret["pv"]    = Command(&Calculator::printVariables);
-    ret["pvd"]   = Command(&Calculator::printVariablesDetailed);
-    ret["pushh"] = Command(&Calculator::pushHistory);
-    ret["sqrt"]  = Command(&Calculator::sqrtTop);
-    ret["swap"]  = Command(&Calculator::swap);
-    ret["unset"] = Command(&Calculator::unset, 1);
-    ret["ver"]   = Command(&Calculator::printVersion);
-    ret["x"]     = Command(&Calculator::exit);
-
-    return ret;
+template <class T>
+const typename BasicCalculator<T>::BuiltinCommand*
+BasicCalculator<T>::builtinCommands(size_t& count)
+{
+    // must be sorted by name.
+    static constexpr BuiltinCommand commands[] =
+    {
+        { "dup",    &BasicCalculator::dup,                    0 },
+        { "help",   &BasicCalculator::printHelp,              0 },
+        { "pack",   &BasicCalculator::pack,                   0 },
+        { "ph",     &BasicCalculator::printHistory,           0 },
+        { "phd",    &BasicCalculator::printHistoryDetailed,   0 },
+        { "pop",    &BasicCalculator::pop,                    0 },
+        { "poph",   &BasicCalculator::popHistory,             0 },
+        { "ps",     &BasicCalculator::printStack,             0 },
+        { "psd",    &BasicCalculator::printStackDetailed,     0 },
+        { "pushh",  &BasicCalculator::pushHistory,            0 },
+        { "pv",     &BasicCalculator::printVariables,         0 },
+        { "pvd",    &BasicCalculator::printVariablesDetailed, 0 },
+        { "stats",  &BasicCalculator::printStatistics,        0 },
+        { "swap",   &BasicCalculator::swap,                   0 },
+        { "unpack", &BasicCalculator::unpack,                 0 },
+        { "unset",  &BasicCalculator::unset,                  1 },
+        { "ver",    &BasicCalculator::printVersion,           0 },
+        { "x",      &BasicCalculator::exit,                   0 }
+    };
+    static_assert(sortedByName(commands), "commands must be sorted by name");
+
+    count = sizeof(commands) / sizeof(*commands);
+    return commands;
 }
+
+#define INSTANTIATE(T) \
+    template const BasicCalculator<T>::BuiltinCommand* \
+    BasicCalculator<T>::builtinCommands(size_t&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
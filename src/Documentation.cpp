@@ -26,11 +26,11 @@
  *
  * Commands are like operators in implementation, but are separate because they
  * affect the calculator as a whole--it's stack, variables, etc. Operators only
- * affect the stack. This limitation is part of the design of the program. A
- * downside to this is that operators can only have two operands. This isn't
- * much of a problem yet, but it may be later if one wants to add a ternary
- * operator. For now, anything that can't be implemented as an operator should
- * be implemented as a command.
+ * affect the stack. An operator takes one, two, or three operands from the top
+ * of the stack and replaces them with its result: "2 sqrt", "3 4 +", and
+ * "2 3 4 fma" each leave one number. If there aren't enough operands, the
+ * operator is treated like a variable instead. Anything that can't be
+ * implemented as an operator should be implemented as a command.
  *
  * Variables let you save the results of your expressions and keep shorthands
  * for commonly used numbers. There are some predefined variables like PI, E,
@@ -47,7 +47,21 @@
  * 16383 before reaching "infinity"--a 4932 digit number. So, though this is not
  * an arbitrary precision calculator, it should be good enough for most people.
  * If you compile with the flag RPN_DOUBLE, however, then "doubles" will be used
- * instead.
+ * by default instead. The console port can also choose when it starts: run it
+ * with --type=float, --type=double or --type=long-double. Doubles are a good
+ * deal faster than long doubles, and operators on arrays can use SIMD.
+ *
+ * A formula can also be turned into C++ and linked into another program.
+ * "rpn --emit-cpp '2 r r r * PI *'" prints a function, rpn_program(), that
+ * returns what the program leaves on top of the stack, using the same
+ * operator functions as the calculator (from src/Operators.h). "rpn --emit-so
+ * '2 r r r * PI *' formula.so" compiles it into a shared object with $CXX.
+ *
+ * A formula that's fixed when a program is built needn't be interpreted at
+ * all. src/Eval.h evaluates formulas at compile time with the same operator
+ * functions: RPN::evaluate("3 4 + 2 *") is a constant 14 in C++17, and in
+ * C++20, RPN::eval<"3 4 + 2 *">() always is. RPN::formula<"w h *">() gives a
+ * function of w and h whose parsing was done by the compiler.
  *
  * I'm not quite sure how portable this program is. It compiles on Ubuntu Linux,
  * so it will likely compile on any GNU/Linux system with the right libraries. I
@@ -59,7 +73,8 @@
  *
  * Hopefully, compiling can be as simple as "make; make install". However, you
  * may need to make changes to the Makefile, and may need to type, for instance,
- * "sudo make install" instead.
+ * "sudo make install" instead. The program is written in C++11, so the
+ * compiler must support it; the Makefiles ask for it with -std=c++11.
  *
  * Compiling for the PSP should not present any difficulties if you already have
  * a PSP SDK and toolchain installed. If not, you can find a great tutorial on
@@ -107,10 +122,13 @@
  * \code
  * [3.23599] 2 1
  * [1]> ps
- * [ 1, 2, 3.23599, ]
+ * [ 1, 2, 3.2359877566666666667, ]
  * [1]>
  * \endcode
  *
+ * The prompt rounds to six digits, but ps prints as many digits as it takes
+ * to read the exact same number back in.
+ *
  * How about removing the top item of the stack?
  *
  * \code
@@ -122,7 +140,7 @@
  *
  * \code
  * [2]> dup ps
- * [2, 2, 3.23599, ]
+ * [ 2, 2, 3.2359877566666666667, ]
  * \endcode
  *
  * Can you print the stack in more detail?
@@ -132,6 +150,19 @@
  * [ 2.000000, 2.000000, 3.235988, ]
  * \endcode
  *
+ * Can you work on many numbers at once? Yes: pack turns the top n items into
+ * an array, where n is the topmost item, and operators apply to each element.
+ * A single number is used for every element. Arrays of different lengths
+ * can't be combined, so then the operator leaves them on the stack and is
+ * treated like a variable, just as if there were too few operands.
+ *
+ * \code
+ * [2]> 1 2 3 3 pack 10 *
+ * [{ 10, 20, 30, }]> dup +
+ * [{ 20, 40, 60, }]> unpack ps
+ * [ 60, 40, 20, 2, 2, 3.2359877566666666667, ]
+ * \endcode
+ *
  * \section thanks Thanks
  *
  * Much thanks to Troy Hanson for uthash. It made the program much better, and
@@ -0,0 +1,447 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Eval.h - evaluating programs at compile time.                               *
+ ******************************************************************************/
+
+#ifndef RPN_EVAL_H
+#define RPN_EVAL_H
+
+#if __cplusplus >= 201703L
+
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <string_view>
+#include "Operators.h"
+
+namespace RPN
+{
+    //! Evaluation of programs of numbers and operators by the compiler, for
+    //! formulas that are fixed when the program is built. This header stands
+    //! alone; it only shares the operator functions with the calculator.
+    namespace Constant
+    {
+        //! An operator that can be evaluated at compile time.
+        template <class T>
+        struct Operator
+        {
+            std::string_view name;
+            unsigned         arity;
+            T                (*unary)(T);
+            T                (*binary)(T, T);
+            T                (*ternary)(T, T, T);
+        };
+
+#define RPN_UNARY(name, f)   { name, 1, Operators::f<T>, nullptr, nullptr }
+#define RPN_BINARY(name, f)  { name, 2, nullptr, Operators::f<T>, nullptr }
+#define RPN_TERNARY(name, f) { name, 3, nullptr, nullptr, Operators::f<T> }
+
+        //! The operators, as in builtinOperators() in Operators.cpp.
+        template <class T>
+        inline constexpr Operator<T> operators[] =
+        {
+            RPN_BINARY ("%",      modulo),
+            RPN_BINARY ("&",      _and),
+            RPN_BINARY ("*",      multiplication),
+            RPN_BINARY ("**",     power),
+            RPN_BINARY ("+",      addition),
+            RPN_BINARY ("-",      subtraction),
+            RPN_BINARY ("/",      division),
+            RPN_BINARY ("=",      equals),
+            RPN_BINARY ("^",      _xor),
+            RPN_UNARY  ("abs",    _abs),
+            RPN_UNARY  ("ceil",   _ceil),
+            RPN_TERNARY("clamp",  _clamp),
+            RPN_UNARY  ("cos",    _cos),
+            RPN_UNARY  ("exp",    _exp),
+            RPN_UNARY  ("floor",  _floor),
+            RPN_TERNARY("fma",    _fma),
+            RPN_UNARY  ("ln",     _ln),
+            RPN_BINARY ("log",    _log),
+            RPN_UNARY  ("round",  _round),
+            RPN_TERNARY("select", _select),
+            RPN_UNARY  ("sin",    _sin),
+            RPN_UNARY  ("sqrt",   _sqrt),
+            RPN_UNARY  ("tan",    _tan),
+            RPN_BINARY ("|",      _or)
+        };
+
+#undef RPN_UNARY
+#undef RPN_BINARY
+#undef RPN_TERNARY
+
+        //! Returns the operator of a name, or nullptr if there isn't one.
+        template <class T>
+        constexpr const Operator<T>* findOperator(std::string_view name)
+        {
+            for(const Operator<T>& op : operators<T>)
+                if(op.name == name)
+                    return &op;
+            return nullptr;
+        }
+
+        //! Powers of ten that are exact in an 80-bit long double, as in
+        //! Numbers.cpp. A narrower type only uses the ones it holds exactly.
+        inline constexpr long double powers[] =
+        {
+            1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,
+            1e9L,  1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L,
+            1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L,
+            1e27L
+        };
+
+        //! The last index of powers.
+        inline constexpr int maxPower = sizeof(powers) / sizeof(*powers) - 1;
+
+        //! Returns the largest power of ten that T represents exactly.
+        template <class T>
+        constexpr int maxExactPower()
+        {
+            const unsigned long long limit =
+                std::numeric_limits<T>::digits >= 64 ?
+                ~0ULL : 1ULL << std::numeric_limits<T>::digits;
+            unsigned long long five = 1;
+            int ret = 0;
+
+            while(ret < maxPower && five <= limit / 5)
+            {
+                five *= 5;
+                ++ret;
+            }
+
+            return ret;
+        }
+
+        //! Returns true if the mantissa has more bits than T holds exactly.
+        template <class T>
+        constexpr bool tooWide(unsigned long long mantissa)
+        {
+            const int digits = std::numeric_limits<T>::digits;
+
+            return digits < 64 && mantissa >> (digits < 64 ? digits : 0);
+        }
+
+        //! Parses a decimal number, with an optional sign, fraction and
+        //! exponent, returning false if the token isn't one. As in
+        //! Numbers.cpp, the result is correctly rounded when the digits fit
+        //! in T and the power of ten is exact in it: 1e22 for a double, or
+        //! 1e23 once a zero moves into the mantissa. Other numbers are
+        //! scaled in long double and can differ from the calculator's in
+        //! the last place, and digits after the 19th are ignored.
+        template <class T>
+        constexpr bool parseNumber(std::string_view s, T& out)
+        {
+            const int exact = maxExactPower<T>();
+            unsigned long long mantissa = 0;
+            bool negative = false, negativeExponent = false;
+            int digits = 0, exponent = 0, written = 0, e = 0, step = 0;
+            size_t i = 0;
+            long double wide = 0;
+            T value = 0;
+
+            if(i < s.size() && (s[i] == '-' || s[i] == '+'))
+                negative = s[i++] == '-';
+
+            for(; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, ++digits)
+                if(mantissa < 1000000000000000000ULL)
+                    mantissa = mantissa * 10 + (s[i] - '0');
+                else
+                    ++exponent;
+
+            if(i < s.size() && s[i] == '.')
+                for(++i; i < s.size() && s[i] >= '0' && s[i] <= '9';
+                    ++i, ++digits)
+                    if(mantissa < 1000000000000000000ULL)
+                    {
+                        mantissa = mantissa * 10 + (s[i] - '0');
+                        --exponent;
+                    }
+
+            if(!digits)
+                return false;
+
+            if(i < s.size() && (s[i] == 'e' || s[i] == 'E'))
+            {
+                if(++i < s.size() && (s[i] == '-' || s[i] == '+'))
+                    negativeExponent = s[i++] == '-';
+                for(digits = 0; i < s.size() && s[i] >= '0' && s[i] <= '9';
+                    ++i, ++digits)
+                    if(written < 100000)
+                        written = written * 10 + (s[i] - '0');
+                if(!digits)
+                    return false;
+                exponent += negativeExponent ? -written : written;
+            }
+
+            if(i != s.size())
+                return false;
+
+            // a power just past the exact ones can still be done exactly by
+            // moving some of its zeros into the mantissa.
+            while(mantissa && exponent > exact && exponent <= exact + 19 &&
+                  mantissa <= ~0ULL / 10 && !tooWide<T>(mantissa * 10))
+            {
+                mantissa *= 10;
+                --exponent;
+            }
+
+            e = exponent < 0 ? -exponent : exponent;
+
+            // an exact mantissa and an exact power of ten give a correctly
+            // rounded result from a single multiplication or division.
+            if(!mantissa)
+                value = 0;
+            else if(!tooWide<T>(mantissa) && e <= exact)
+                value = exponent < 0 ? T(mantissa) / T(powers[e])
+                                     : T(mantissa) * T(powers[e]);
+            else if(exponent > std::numeric_limits<T>::max_exponent10)
+                value = std::numeric_limits<T>::infinity();
+            else if(exponent < std::numeric_limits<T>::min_exponent10 - 40)
+                value = 0;
+            else
+            {
+                for(wide = mantissa; e; e -= step)
+                {
+                    step = e < maxPower ? e : maxPower;
+                    if(exponent < 0)
+                        wide /= powers[step];
+                    else if(wide <= std::numeric_limits<long double>::max() /
+                                    powers[step])
+                        wide *= powers[step];
+                    else
+                        wide = std::numeric_limits<long double>::infinity();
+                }
+                value = wide > std::numeric_limits<T>::max() ?
+                        std::numeric_limits<T>::infinity() : T(wide);
+            }
+
+            out = negative ? -value : value;
+            return true;
+        }
+
+        //! What a step of a compiled program does.
+        enum Kind
+        {
+            Literal,
+            Variable,
+            Apply
+        };
+
+        //! A step of a compiled program.
+        template <class T>
+        struct Step
+        {
+            Kind               kind;
+            T                  value;
+            size_t             variable;
+            const Operator<T>* op;
+        };
+
+        //! A program compiled to at most N steps.
+        template <class T, size_t N>
+        struct Code
+        {
+            Step<T> steps[N];
+            size_t  size;
+            size_t  variables;
+            bool    valid;
+        };
+
+        //! Compiles a program of at most N tokens. Names that aren't
+        //! operators are variables, numbered in the order they first appear.
+        //! The code isn't valid if an operator doesn't have enough operands.
+        template <class T, size_t N>
+        constexpr Code<T, N> compile(std::string_view program)
+        {
+            Code<T, N> code = {};
+            std::string_view names[N] = {};
+            size_t i = 0, height = 0;
+
+            code.valid = true;
+
+            while(true)
+            {
+                while(i < program.size() && (program[i] == ' ' ||
+                      program[i] == '\t' || program[i] == '\n'))
+                    ++i;
+                if(i == program.size())
+                    break;
+
+                size_t begin = i;
+                while(i < program.size() && program[i] != ' ' &&
+                      program[i] != '\t' && program[i] != '\n')
+                    ++i;
+
+                std::string_view token = program.substr(begin, i - begin);
+                Step<T>& step = code.steps[code.size++];
+
+                if(parseNumber(token, step.value))
+                    step.kind = Literal;
+                else if((step.op = findOperator<T>(token)))
+                {
+                    step.kind = Apply;
+                    if(height < step.op->arity)
+                        code.valid = false;
+                    else
+                        height -= step.op->arity;
+                }
+                else
+                {
+                    step.kind = Variable;
+                    for(step.variable = 0;
+                        step.variable < code.variables &&
+                        names[step.variable] != token; ++step.variable)
+                        ;
+                    if(step.variable == code.variables)
+                        names[code.variables++] = token;
+                }
+
+                ++height;
+            }
+
+            return code;
+        }
+
+        //! Stands for the result of an invalid program. It isn't constexpr,
+        //! so using one at compile time is an error.
+        template <class T>
+        inline T invalid()
+        {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+
+        //! Runs a compiled program, returning the top of the stack or 0 if
+        //! it's empty.
+        template <class T, size_t N>
+        constexpr T run(const Code<T, N>& code, const T* arguments,
+                        size_t count)
+        {
+            T stack[N + 1] = {};
+            size_t height = 0;
+
+            if(!code.valid || count < code.variables)
+                return invalid<T>();
+
+            for(size_t i = 0; i < code.size; ++i)
+            {
+                const Step<T>& step = code.steps[i];
+                const T* x = stack;
+
+                if(step.kind == Literal)
+                    stack[height++] = step.value;
+                else if(step.kind == Variable)
+                    stack[height++] = arguments[step.variable];
+                else
+                {
+                    height -= step.op->arity;
+                    x = stack + height;
+                    stack[height++] =
+                        step.op->arity == 1 ? step.op->unary(x[0]) :
+                        step.op->arity == 2 ? step.op->binary(x[0], x[1]) :
+                        step.op->ternary(x[0], x[1], x[2]);
+                }
+            }
+
+            return height ? stack[height - 1] : 0;
+        }
+    }
+
+    //! Evaluates a program, at compile time when it's used as a constant:
+    //! RPN::evaluate("3 4 + 2 *") is 14. Names that aren't operators are
+    //! variables, which take the values of the arguments in the order they
+    //! first appear, so RPN::evaluate("w h *", {3.0, 4.0}) is 12. Unlike
+    //! the calculator, an operator without enough operands is an error.
+    template <class T = double, size_t N>
+    constexpr T evaluate(const char (&program)[N],
+                         std::initializer_list<T> arguments = {})
+    {
+        return Constant::run(
+            Constant::compile<T, N>(std::string_view(program, N - 1)),
+            arguments.begin(), arguments.size());
+    }
+
+#if defined(__cpp_nontype_template_args) && \
+    __cpp_nontype_template_args >= 201911L
+    //! A program given as a template argument.
+    template <size_t N>
+    struct Program
+    {
+        char text[N];
+
+        constexpr Program(const char (&s)[N])
+            : text()
+        {
+            for(size_t i = 0; i < N; ++i)
+                text[i] = s[i];
+        }
+
+        constexpr std::string_view View() const
+        {
+            return std::string_view(text, N - 1);
+        }
+    };
+
+    //! The compiled code of a program given as a template argument.
+    template <Program P, class T>
+    inline constexpr auto programCode =
+        Constant::compile<T, sizeof(P.text)>(P.View());
+
+    //! Evaluates a program without variables, which always happens at
+    //! compile time: RPN::eval<"3 4 + 2 *">() is 14.
+    template <Program P, class T = double>
+    constexpr T eval()
+    {
+        static_assert(programCode<P, T>.valid,
+                      "an operator doesn't have enough operands");
+        static_assert(programCode<P, T>.variables == 0,
+                      "use RPN::formula for a program with variables");
+        constexpr T value = Constant::run(programCode<P, T>,
+                                            (const T*)nullptr, 0);
+        return value;
+    }
+
+    //! Returns a function of the variables of a program, whose parsing is
+    //! done at compile time: RPN::formula<"w h *">()(3, 4) is 12.
+    template <Program P, class T = double>
+    constexpr auto formula()
+    {
+        static_assert(programCode<P, T>.valid,
+                      "an operator doesn't have enough operands");
+        return [](auto... values) constexpr
+        {
+            const T arguments[] = { T(values)..., T() };
+            return Constant::run(programCode<P, T>, arguments,
+                                 sizeof...(values));
+        };
+    }
+#endif
+}
+
+#endif
+
+#endif
@@ -29,39 +29,55 @@
  ******************************************************************************/
 
 #include "rpn.h"
-#include <boost/foreach.hpp>
 using namespace RPN;
 using namespace std;
 
-void RPN::printHelpItems(const HelpItems& items)
+void RPN::printHelpItems(const HelpItem* items, size_t count)
 {
-    BOOST_FOREACH(const HelpItem& item, items)
+    for(size_t i = 0; i < count; ++i)
     {
         Print("    ");
-        Print(item.Brief());
+        Print(items[i].brief);
         Print("\n        ");
-        Print(item.Description());
+        Print(items[i].description);
         Print("\n");
     }
 }
 
-HelpItems RPN::defaultHelpItems()
+const HelpItem* RPN::defaultHelpItems(size_t& count)
 {
-    HelpItems items;
-
-    items.push_back(HelpItem("+, -, *, /, **, sqrt, log, =",
-                             "The basic math operators."));
-    items.push_back(HelpItem("%, ^, &, |",
-                             "Modulo and bitwise operators."));
-    items.push_back(HelpItem("dup", "Pushes the topmost value to the stack."));
-    items.push_back(HelpItem("pop", "Removes the topmost value of the stack."));
-    items.push_back(HelpItem("ph",  "Prints the history stack."));
-    items.push_back(HelpItem("phd", "Prints the history stack in detail."));
-    items.push_back(HelpItem("ps",  "Prints the stack."));
-    items.push_back(HelpItem("psd", "Prints the stack in detail."));
-    items.push_back(HelpItem("pv",  "Prints the variable map."));
-    items.push_back(HelpItem("pvd", "Prints the variable map in detail."));
-    items.push_back(HelpItem("x",   "Exits the program."));
+    static const HelpItem items[] =
+    {
+        { "+, -, *, /, **, log, =",
+          "The basic math operators." },
+        { "abs, ceil, floor, round, sqrt, exp, ln, sin, cos, tan",
+          "Replace the top value with its absolute value, rounding, square "
+          "root, etc." },
+        { "fma, select, clamp",
+          "\"a b c fma\" is a * b + c; \"c a b select\" is a if c is "
+          "nonzero, else b; \"x lo hi clamp\" limits x to [lo, hi]." },
+        { "%, ^, &, |",
+          "Modulo and bitwise operators." },
+        { "pack",
+          "Packs the top n values into an array, where n is the topmost "
+          "value. Operators work on each element. On arrays of different "
+          "lengths they act as variables, as with too few operands." },
+        { "unpack",
+          "Replaces the topmost array with its elements." },
+        { "dup", "Pushes the topmost value to the stack." },
+        { "pop", "Removes the topmost value of the stack." },
+        { "ph",  "Prints the history stack." },
+        { "phd", "Prints the history stack in detail." },
+        { "ps",  "Prints the stack." },
+        { "psd", "Prints the stack in detail." },
+        { "pv",  "Prints the variable map." },
+        { "pvd", "Prints the variable map in detail." },
+        { "stats",
+          "Prints how often each operator, command, variable and literal has "
+          "run and how long it took, when built with RPN_STATS." },
+        { "x",   "Exits the program." }
+    };
 
+    count = sizeof(items) / sizeof(*items);
     return items;
 }
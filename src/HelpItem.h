@@ -30,35 +30,15 @@
 
 #ifndef RPN_HELPITEM_H
 #define RPN_HELPITEM_H
-#include <string>
 
 namespace RPN
 {
-    class HelpItem
+    //! An entry of the help list. The list is a plain array, like the tables
+    //! of built-ins, so it costs nothing until help is asked for.
+    struct HelpItem
     {
-        std::string brief;
-        std::string description;
-
-    public:
-        HelpItem(std::string& brief, std::string& description)
-            : brief(brief), description(description)
-        {
-        }
-
-        HelpItem(const char* brief, const char* description)
-            : brief(brief), description(description)
-        {
-        }
-
-        const std::string& Brief() const
-        {
-            return brief;
-        }
-
-        const std::string& Description() const
-        {
-            return description;
-        }
+        const char* brief;
+        const char* description;
     };
 }
 
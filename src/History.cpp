@@ -32,7 +32,8 @@
 using namespace std;
 using namespace RPN;
 
-History RPN::defaultHistory()
+template <class T>
+typename BasicCalculator<T>::History BasicCalculator<T>::defaultHistory()
 {
     History ret;
 
@@ -40,3 +41,8 @@ History RPN::defaultHistory()
 
     return ret;
 }
+
+#define INSTANTIATE(T) \
+    template BasicCalculator<T>::History \
+    BasicCalculator<T>::defaultHistory();
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Instruction.h - header for the Instruction class.                           *
+ ******************************************************************************/
+
+#ifndef RPN_INSTRUCTION_H
+#define RPN_INSTRUCTION_H
+
+#include <cstddef>
+#include "typedefs.h"
+#include "Command.h"
+#include "Operation.h"
+
+namespace RPN
+{
+    //! A single step of a compiled program. Eval() compiles each line of input
+    //! into a list of these once, so that running the line again doesn't need
+    //! to tokenize it or look anything up. An instruction owns nothing: names
+    //! point into the built-in tables, and the arguments of commands are kept
+    //! by the program, so instructions are small and cheap to copy.
+    template <class T>
+    class BasicInstruction
+    {
+    public:
+
+        //! The type of the operation of a CallOperator.
+        typedef BasicOperation<T> Operation;
+        //! The type of the command of a CallCommand.
+        typedef BasicCommand<T>   Command;
+
+        //! The arguments index of a CallCommand whose command takes none.
+        static const size_t NO_ARGUMENTS = (size_t)-1;
+
+        //! What the instruction does when run.
+        enum Opcode
+        {
+            //! Pushes a number onto the stack.
+            PushLiteral,
+            //! Applies an operator to the top items of the stack.
+            CallOperator,
+            //! Performs a command with its arguments.
+            CallCommand,
+            //! Pushes a variable, or sets it if it doesn't exist yet.
+            Variable,
+            //! Runs the literals and operators that follow as a block of the
+            //! program if the stack allows it; otherwise they're run one by
+            //! one.
+            RunBlock
+        };
+
+    private:
+
+        Opcode      opcode;
+        T           value;
+        Operation   oper;
+        Command     command;
+        size_t      index;
+        size_t      slot;
+        const char* name;
+#ifdef RPN_STATS
+        size_t      statistic;
+#endif
+
+        BasicInstruction(Opcode opcode, const char* name)
+            : opcode(opcode), value(0), oper(), command(), index(0), slot(0),
+              name(name)
+#ifdef RPN_STATS
+              , statistic(0)
+#endif
+        {
+        }
+
+    public:
+
+        //! Creates an instruction that pushes a number.
+        static BasicInstruction Literal(T value)
+        {
+            BasicInstruction ret(PushLiteral, "");
+            ret.value = value;
+            return ret;
+        }
+
+        //! Creates an instruction that applies an operator. The slot of the
+        //! variable of the same name is kept because an operator without
+        //! enough operands acts like a variable.
+        static BasicInstruction Oper(const char* name, const Operation& oper,
+                                     size_t slot)
+        {
+            BasicInstruction ret(CallOperator, name);
+            ret.oper = oper;
+            ret.slot = slot;
+            return ret;
+        }
+
+        //! Creates an instruction that performs a command with the
+        //! arguments at an index of its program, or NO_ARGUMENTS.
+        static BasicInstruction Cmd(const char* name, const Command& command,
+                                    size_t arguments)
+        {
+            BasicInstruction ret(CallCommand, name);
+            ret.command = command;
+            ret.index = arguments;
+            return ret;
+        }
+
+        //! Creates an instruction that pushes or sets the variable in a slot.
+        static BasicInstruction Var(size_t slot)
+        {
+            BasicInstruction ret(Variable, "");
+            ret.slot = slot;
+            return ret;
+        }
+
+        //! Creates an instruction that runs the program's block at an index,
+        //! which stands for the given number of instructions after it.
+        static BasicInstruction Threaded(size_t block, size_t length)
+        {
+            BasicInstruction ret(RunBlock, "");
+            ret.index = block;
+            ret.slot = length;
+            return ret;
+        }
+
+        //! Returns what the instruction does.
+        Opcode Code() const { return opcode; }
+
+        //! Returns the number pushed by a PushLiteral.
+        T Number() const { return value; }
+
+        //! Returns the operation of a CallOperator.
+        const Operation& GetOperation() const { return oper; }
+
+        //! Returns the variable slot of a CallOperator or Variable.
+        size_t Slot() const { return slot; }
+
+        //! Returns the index of the block of a RunBlock in its program.
+        size_t BlockIndex() const { return index; }
+
+        //! Returns how many instructions the block of a RunBlock stands for.
+        size_t Length() const { return slot; }
+
+        //! Returns the command of a CallCommand.
+        const Command& GetCommand() const { return command; }
+
+        //! Returns the name of the operator of a CallOperator or the command
+        //! of a CallCommand.
+        const char* Name() const { return name; }
+
+        //! Returns the index of the arguments of a CallCommand in its
+        //! program, or NO_ARGUMENTS.
+        size_t Arguments() const { return index; }
+
+#ifdef RPN_STATS
+        //! Returns the row of the instruction's statistics.
+        size_t Statistic() const { return statistic; }
+
+        //! Sets the row of the instruction's statistics.
+        void SetStatistic(size_t row) { statistic = row; }
+#endif
+    };
+}
+
+#endif
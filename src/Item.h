@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+/*******************************************************************************
+ * Item.h - header for the Item class.                                         *
+ ******************************************************************************/
+
+#ifndef RPN_ITEM_H
+#define RPN_ITEM_H
+
+#include <cstddef>
+#include <vector>
+#include "typedefs.h"
+
+namespace RPN
+{
+    //! An item of the stack or a variable: either a single value or an array
+    //! of them. Arrays are reference counted, so copying an item never copies
+    //! its elements; an array is only copied when a shared one is written to.
+    template <class T>
+    class BasicItem
+    {
+        //! The reference-counted elements of an array.
+        struct Elements
+        {
+            size_t         refs;
+            std::vector<T> values;
+
+            Elements(size_t n) : refs(1), values(n) {}
+        };
+
+        T         value;
+        Elements* elements;
+
+        //! Drops the reference to the elements, freeing them if it was the
+        //! last.
+        void Release()
+        {
+            if(elements && --elements->refs == 0)
+                delete elements;
+        }
+
+    public:
+
+        //! Creates a single value.
+        BasicItem(T value = 0)
+            : value(value), elements(NULL)
+        {
+        }
+
+        //! Copies another item, sharing its elements.
+        BasicItem(const BasicItem& other)
+            : value(other.value), elements(other.elements)
+        {
+            if(elements)
+                ++elements->refs;
+        }
+
+        ~BasicItem()
+        {
+            Release();
+        }
+
+        BasicItem& operator=(const BasicItem& other)
+        {
+            if(other.elements)
+                ++other.elements->refs;
+            Release();
+            value = other.value;
+            elements = other.elements;
+            return *this;
+        }
+
+        //! Creates an array of n elements, all zero.
+        static BasicItem Array(size_t n)
+        {
+            BasicItem ret;
+            ret.elements = new Elements(n);
+            return ret;
+        }
+
+        //! Returns true if the item is an array.
+        bool IsArray() const { return elements != NULL; }
+
+        //! Returns the value of a single-value item.
+        T Scalar() const { return value; }
+
+        //! Returns the number of values in the item.
+        size_t Size() const { return elements ? elements->values.size() : 1; }
+
+        //! Returns the values of the item.
+        const T* Data() const
+        {
+            if(!elements)
+                return &value;
+            return elements->values.empty() ? NULL : &elements->values[0];
+        }
+
+        //! Returns true if no other item shares the elements.
+        bool Unique() const { return !elements || elements->refs == 1; }
+
+        //! Returns writable values, copying the elements first if they're
+        //! shared.
+        T* MutableData()
+        {
+            if(!Unique())
+            {
+                Elements* copy = new Elements(*elements);
+                copy->refs = 1;
+                --elements->refs;
+                elements = copy;
+            }
+
+            return const_cast<T*>(Data());
+        }
+    };
+}
+
+#endif
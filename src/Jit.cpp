@@ -0,0 +1,447 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Jit.cpp - compiles blocks to x86-64 machine code.                           *
+ ******************************************************************************/
+
+#include <cstring>
+#include "rpn.h"
+#include "Jit.h"
+
+#ifdef RPN_JIT
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+using namespace RPN;
+
+#ifdef RPN_JIT
+namespace
+{
+    // the second byte of each SSE instruction used, after 0x0F. the prefix
+    // before them chooses between the single and double versions.
+    enum SseOp
+    {
+        MOVS_LOAD  = 0x10,
+        MOVS_STORE = 0x11,
+        SQRTS      = 0x51,
+        ADDS       = 0x58,
+        MULS       = 0x59,
+        SUBS       = 0x5C,
+        DIVS       = 0x5E
+    };
+
+    // RBX holds the registers passed to the code, since calls preserve it.
+    const unsigned RBX = 3;
+
+    // which types can be kept in SSE registers.
+    template <class T> struct Sse         { static const bool OK = false; };
+    template <>        struct Sse<float>  { static const bool OK = true;  };
+    template <>        struct Sse<double> { static const bool OK = true;  };
+
+    // writes the machine code for values of a given width, 4 or 8 bytes.
+    class Assembler
+    {
+        vector<unsigned char> code;
+        size_t                width;
+
+        void Byte(unsigned b)
+        {
+            code.push_back((unsigned char)b);
+        }
+
+        // copies bytes as they're laid out in memory, which is little-endian
+        // like the immediates of the instructions.
+        void Bytes(const void* p, size_t n)
+        {
+            const unsigned char* bytes = (const unsigned char*)p;
+            code.insert(code.end(), bytes, bytes + n);
+        }
+
+        // the REX prefix, needed for 64-bit operands and registers past 7.
+        void Rex(bool wide, unsigned reg, unsigned rm)
+        {
+            unsigned rex = 0x40 | (wide ? 8 : 0) | (reg >> 3) << 2 | rm >> 3;
+            if(rex != 0x40)
+                Byte(rex);
+        }
+
+        void Prefix()
+        {
+            Byte(width == 8 ? 0xF2 : 0xF3);
+        }
+
+    public:
+
+        Assembler(size_t width)
+            : code(), width(width)
+        {
+        }
+
+        const vector<unsigned char>& Code() const { return code; }
+
+        // push rbx; mov rbx, rdi
+        void Enter()
+        {
+            Byte(0x53); Byte(0x48); Byte(0x89); Byte(0xFB);
+        }
+
+        // pop rbx; ret
+        void Leave()
+        {
+            Byte(0x5B); Byte(0xC3);
+        }
+
+        // op xmm, xmm
+        void Op(unsigned op, unsigned dst, unsigned src)
+        {
+            Prefix();
+            Rex(false, dst, src);
+            Byte(0x0F); Byte(op); Byte(0xC0 | (dst & 7) << 3 | (src & 7));
+        }
+
+        // op xmm, [rbx + offset], or the other way around for a store.
+        void OpMemory(unsigned op, unsigned reg, int offset)
+        {
+            Prefix();
+            Rex(false, reg, RBX);
+            Byte(0x0F); Byte(op); Byte(0x80 | (reg & 7) << 3 | RBX);
+            Bytes(&offset, 4);
+        }
+
+        // mov rax, value; movq xmm, rax (or their 32-bit versions).
+        void LoadConstant(unsigned reg, const void* value)
+        {
+            if(width == 8)
+                Byte(0x48);
+            Byte(0xB8); Bytes(value, width);
+            Byte(0x66);
+            Rex(width == 8, reg, 0);
+            Byte(0x0F); Byte(0x6E); Byte(0xC0 | (reg & 7) << 3);
+        }
+
+        // mov rax, value; mov [rbx + offset], rax (or their 32-bit versions).
+        void StoreConstant(int offset, const void* value)
+        {
+            if(width == 8)
+                Byte(0x48);
+            Byte(0xB8); Bytes(value, width);
+            if(width == 8)
+                Byte(0x48);
+            Byte(0x89); Byte(0x83); Bytes(&offset, 4);
+        }
+
+        // mov rax, function; call rax
+        void Call(const void* function)
+        {
+            Byte(0x48); Byte(0xB8); Bytes(function, 8);
+            Byte(0xFF); Byte(0xD0);
+        }
+    };
+
+    // compiles a block to code that keeps the values of the block in SSE
+    // registers, and uses the registers it's given as memory for those it
+    // can't keep. the value at depth d is kept in xmm(d % 16), or else in
+    // registers[d + 1]. arithmetic and square roots are done inline, while
+    // the other operators are called, which spills every value first.
+    template <class T>
+    class BlockCompiler
+    {
+        typedef BasicBlock<T>                               Block;
+        typedef typename Block::Step                        Step;
+        typedef typename BasicCalculator<T>::BuiltinOperator BuiltinOperator;
+
+        // where a value is while the code runs.
+        enum Place
+        {
+            InMemory,
+            InRegister,
+            Constant
+        };
+
+        static const unsigned NUM_REGISTERS = 16;
+
+        const Block&  block;
+        Assembler     assembler;
+        vector<Place> places;
+        vector<T>     constants;
+        long          owners[NUM_REGISTERS];
+
+        static int Offset(size_t depth)
+        {
+            return (int)((depth + 1) * sizeof(T));
+        }
+
+        static unsigned RegisterOf(size_t depth)
+        {
+            return depth % NUM_REGISTERS;
+        }
+
+        // returns the function of a built-in operator.
+        static const BuiltinOperator* Builtin(const char* name)
+        {
+            size_t count;
+            const BuiltinOperator* table;
+
+            table = BasicCalculator<T>::builtinOperators(count);
+            return findBuiltin(table, count, name);
+        }
+
+        // returns the function of an operator the optimizer puts in.
+        static const BuiltinOperator* Derived(const char* name)
+        {
+            size_t count;
+            const BuiltinOperator* table;
+
+            table = BasicCalculator<T>::derivedOperators(count);
+            return findBuiltin(table, count, name);
+        }
+
+        // moves a value from its register to memory.
+        void Spill(size_t depth)
+        {
+            unsigned reg = RegisterOf(depth);
+
+            assembler.OpMemory(MOVS_STORE, reg, Offset(depth));
+            places[depth] = InMemory;
+            owners[reg] = -1;
+        }
+
+        // moves a value into its register, spilling the one there.
+        unsigned Load(size_t depth)
+        {
+            unsigned reg = RegisterOf(depth);
+
+            if(places[depth] == InRegister)
+                return reg;
+            if(owners[reg] >= 0)
+                Spill(owners[reg]);
+
+            if(places[depth] == Constant)
+                assembler.LoadConstant(reg, &constants[depth]);
+            else
+                assembler.OpMemory(MOVS_LOAD, reg, Offset(depth));
+
+            places[depth] = InRegister;
+            owners[reg] = depth;
+            return reg;
+        }
+
+        // forgets a value that's been used up.
+        void Drop(size_t depth)
+        {
+            if(places[depth] == InRegister)
+                owners[RegisterOf(depth)] = -1;
+        }
+
+        // applies an SSE operation to the values at depth and depth + 1.
+        void Arithmetic(unsigned op, size_t depth)
+        {
+            unsigned reg = Load(depth);
+
+            if(places[depth + 1] == Constant)
+                Load(depth + 1);
+
+            if(places[depth + 1] == InRegister)
+                assembler.Op(op, reg, RegisterOf(depth + 1));
+            else
+                assembler.OpMemory(op, reg, Offset(depth + 1));
+
+            Drop(depth + 1);
+        }
+
+        // calls a function on the values from depth to the top, which are
+        // passed in xmm0 onwards. the result comes back in xmm0.
+        void Call(const void* function, unsigned arity, size_t depth)
+        {
+            unsigned reg = RegisterOf(depth);
+
+            for(size_t i = 0; i < depth + arity; ++i)
+                if(places[i] == InRegister)
+                    Spill(i);
+
+            for(unsigned i = 0; i < arity; ++i)
+            {
+                if(places[depth + i] == Constant)
+                    assembler.LoadConstant(i, &constants[depth + i]);
+                else
+                    assembler.OpMemory(MOVS_LOAD, i, Offset(depth + i));
+            }
+
+            assembler.Call(function);
+
+            if(reg != 0)
+                assembler.Op(MOVS_LOAD, reg, 0);
+            places[depth] = InRegister;
+            owners[reg] = depth;
+        }
+
+    public:
+
+        BlockCompiler(const Block& block)
+            : block(block), assembler(sizeof(T)),
+              places(block.Registers(), InMemory),
+              constants(block.Registers()), owners()
+        {
+            for(unsigned i = 0; i < NUM_REGISTERS; ++i)
+                owners[i] = -1;
+        }
+
+        NativeCode Compile()
+        {
+            const vector<Step>& steps = block.Steps();
+            const BuiltinOperator* add = Builtin("+");
+            const BuiltinOperator* subtract = Builtin("-");
+            const BuiltinOperator* multiply = Builtin("*");
+            const BuiltinOperator* divide = Builtin("/");
+            const BuiltinOperator* sqrt = Builtin("sqrt");
+            const BuiltinOperator* square = Derived("square");
+            size_t height = block.Need();
+
+            assembler.Enter();
+
+            for(size_t i = 0; steps[i].code != Block::End; ++i)
+            {
+                const Step& step = steps[i];
+
+                switch(step.code)
+                {
+                case Block::Literal:
+                    places[height] = Constant;
+                    constants[height] = step.value;
+                    ++height;
+                    break;
+
+                case Block::Unary:
+                    if(step.unary == sqrt->unary)
+                    {
+                        unsigned reg = Load(height - 1);
+                        assembler.Op(SQRTS, reg, reg);
+                    }
+                    else if(step.unary == square->unary)
+                    {
+                        unsigned reg = Load(height - 1);
+                        assembler.Op(MULS, reg, reg);
+                    }
+                    else
+                        Call(&step.unary, 1, height - 1);
+                    break;
+
+                case Block::Binary:
+                    if(step.binary == add->binary)
+                        Arithmetic(ADDS, height - 2);
+                    else if(step.binary == subtract->binary)
+                        Arithmetic(SUBS, height - 2);
+                    else if(step.binary == multiply->binary)
+                        Arithmetic(MULS, height - 2);
+                    else if(step.binary == divide->binary)
+                        Arithmetic(DIVS, height - 2);
+                    else
+                        Call(&step.binary, 2, height - 2);
+                    height -= 1;
+                    break;
+
+                case Block::Ternary:
+                    Call(&step.ternary, 3, height - 3);
+                    height -= 2;
+                    break;
+
+                case Block::End:
+                    break;
+                }
+            }
+
+            // leave the results where the interpreter would.
+            for(size_t i = 0; i < height; ++i)
+            {
+                if(places[i] == InRegister)
+                    Spill(i);
+                else if(places[i] == Constant)
+                    assembler.StoreConstant(Offset(i), &constants[i]);
+            }
+
+            assembler.Leave();
+            return NativeCode::Load(assembler.Code());
+        }
+    };
+}
+#endif
+
+void NativeCode::Release()
+{
+    if(buffer && --buffer->refs == 0)
+    {
+#ifdef RPN_JIT
+        munmap(buffer->memory, buffer->size);
+#endif
+        delete buffer;
+    }
+    buffer = NULL;
+}
+
+NativeCode NativeCode::Load(const vector<unsigned char>& code)
+{
+    NativeCode ret;
+#ifdef RPN_JIT
+    void* memory;
+    Function entry;
+
+    // the memory is never writable and executable at the same time.
+    memory = mmap(NULL, code.size(), PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED)
+        return ret;
+
+    memcpy(memory, &code[0], code.size());
+    if(mprotect(memory, code.size(), PROT_READ | PROT_EXEC))
+    {
+        munmap(memory, code.size());
+        return ret;
+    }
+
+    memcpy(&entry, &memory, sizeof(entry));
+    ret.buffer = new Buffer(memory, code.size(), entry);
+#endif
+    return ret;
+}
+
+template <class T>
+NativeCode NativeCode::Compile(const BasicBlock<T>& block)
+{
+#ifdef RPN_JIT
+    if(Sse<T>::OK)
+    {
+        BlockCompiler<T> compiler(block);
+        return compiler.Compile();
+    }
+#endif
+    return NativeCode();
+}
+
+#define INSTANTIATE(T) \
+    template NativeCode NativeCode::Compile(const BasicBlock<T>&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Jit.h - header for the NativeCode class.                                    *
+ ******************************************************************************/
+
+#ifndef RPN_JIT_H
+#define RPN_JIT_H
+
+#include <cstddef>
+#include <vector>
+#include "typedefs.h"
+
+// blocks are only compiled on x86-64 systems using the System V calling
+// convention; everywhere else they're always interpreted.
+#if defined(__x86_64__) && defined(__unix__) && !defined(RPN_NO_JIT)
+#define RPN_JIT
+#endif
+
+namespace RPN
+{
+    //! Machine code compiled from a block. Copies share the code, which is
+    //! freed along with the last of them.
+    class NativeCode
+    {
+    public:
+
+        //! The type of the compiled code, which takes the same registers as
+        //! BasicBlock::Run().
+        typedef void (*Function)(void* registers);
+
+    private:
+
+        //! Executable memory holding the code.
+        struct Buffer
+        {
+            size_t   refs;
+            void*    memory;
+            size_t   size;
+            Function entry;
+
+            Buffer(void* memory, size_t size, Function entry)
+                : refs(1), memory(memory), size(size), entry(entry)
+            {
+            }
+        };
+
+        Buffer* buffer;
+
+        //! Drops a reference to the buffer, freeing it if it was the last.
+        void Release();
+
+    public:
+
+        //! Creates an empty piece of code.
+        NativeCode()
+            : buffer(NULL)
+        {
+        }
+
+        //! Copies another piece of code, sharing its buffer.
+        NativeCode(const NativeCode& other)
+            : buffer(other.buffer)
+        {
+            if(buffer)
+                ++buffer->refs;
+        }
+
+        ~NativeCode()
+        {
+            Release();
+        }
+
+        NativeCode& operator=(const NativeCode& other)
+        {
+            if(other.buffer)
+                ++other.buffer->refs;
+            Release();
+            buffer = other.buffer;
+            return *this;
+        }
+
+        //! Returns true if there is no code.
+        bool Empty() const { return buffer == NULL; }
+
+        //! Runs the code.
+        void operator()(void* registers) const
+        {
+            buffer->entry(registers);
+        }
+
+        //! Copies machine code into executable memory. Returns empty code if
+        //! that isn't possible.
+        static NativeCode Load(const std::vector<unsigned char>& code);
+
+        //! Compiles a block. Returns empty code if the block or its type
+        //! can't be compiled on this system.
+        template <class T>
+        static NativeCode Compile(const BasicBlock<T>& block);
+    };
+}
+
+#endif
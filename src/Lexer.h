@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Lexer.h - header for the Lexer class.                                       *
+ ******************************************************************************/
+
+#ifndef RPN_LEXER_H
+#define RPN_LEXER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace RPN
+{
+    //! A token of input. It points into the string being lexed rather than
+    //! holding a copy of it.
+    struct Token
+    {
+        const char* begin;
+        size_t      length;
+
+        Token() : begin(NULL), length(0) {}
+
+        //! Returns a copy of the token as a string.
+        std::string Str() const { return std::string(begin, length); }
+    };
+
+    //! Splits input into whitespace-separated tokens without allocating.
+    class Lexer
+    {
+        //! A word of input, examined a few bytes at a time.
+        typedef unsigned long Word;
+
+        const char* pos;
+        const char* end;
+
+        //! Returns true if the character separates tokens.
+        static bool IsSeparator(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n';
+        }
+
+        //! Returns true if any byte of the word might be a separator, i.e. is
+        //! less than or equal to a space. False positives are fine.
+        static bool MaybeSeparator(Word w)
+        {
+            const Word ones = ~(Word)0 / 255;
+            return ((w - ones * 0x21) & ~w & (ones * 0x80)) != 0;
+        }
+
+        //! Returns the end of the token that begins at p. Whole words are
+        //! skipped while none of their bytes can be a separator.
+        const char* TokenEnd(const char* p) const
+        {
+            Word w;
+
+            while(end - p >= (ptrdiff_t)sizeof(Word))
+            {
+                std::memcpy(&w, p, sizeof(Word));
+                if(MaybeSeparator(w))
+                    break;
+                p += sizeof(Word);
+            }
+
+            while(p != end && !IsSeparator(*p))
+                ++p;
+
+            return p;
+        }
+
+    public:
+
+        //! Creates a lexer over a string. The string must outlive it.
+        explicit Lexer(const std::string& input)
+            : pos(input.data()), end(input.data() + input.size())
+        {
+        }
+
+        //! Stores the next token in tok, returning false if there is none.
+        bool Next(Token& tok)
+        {
+            while(pos != end && IsSeparator(*pos))
+                ++pos;
+
+            if(pos == end)
+                return false;
+
+            tok.begin = pos;
+            pos = TokenEnd(pos);
+            tok.length = pos - tok.begin;
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -37,31 +37,62 @@ using namespace RPN;
 PSP_MODULE_INFO("PSPRPN", 0, 1, 1);
 #endif
 
-int main(int argc, char *argv[])
+//! Runs a calculator that operates on values of type T, returning the exit
+//! status of the program.
+template <class T>
+static int run(int argc, char *argv[])
 {
-    Calculator calculator;
+    BasicCalculator<T> calculator;
 
 #ifdef RPN_CONSOLE
-    Arguments arguments;
-    setupArguments(arguments);
-    bool run = processArguments(vectorize(argv, argc), arguments, calculator);
+    ArgumentsOutcome outcome = processArguments(vectorize(argv, argc),
+                                                calculator);
+    bool proceed = outcome == RunCalculator;
+    LatencyHistogram* histogram = latencies();
 #else
-    bool run = true;
+    bool proceed = true;
 #endif
 
     Port::Setup();
 
-    if(run)
+    if(proceed)
         while(calculator.IsRunning() && Port::CanRun())
         {
             //string s;
             Print('[');
             calculator.Display();
             Print("]> ");
+#ifdef RPN_CONSOLE
+            timedEval(calculator, Port::GetLine(), histogram);
+#else
             calculator.Eval(Port::GetLine());
+#endif
         }
 
+#ifdef RPN_CONSOLE
+    finishArguments(calculator);
+#endif
     Port::Post();
 
+#ifdef RPN_CONSOLE
+    if(outcome == ArgumentError)
+        return 1;
+#endif
     return 0;
 }
+
+int main(int argc, char *argv[])
+{
+#ifdef RPN_CONSOLE
+    switch(findValueType(vectorize(argv, argc)))
+    {
+    case FloatType:      return run<float>(argc, argv);
+    case DoubleType:     return run<double>(argc, argv);
+    case LongDoubleType: return run<long double>(argc, argv);
+    case UnknownType:    return 1;
+    default:             return run<Value>(argc, argv);
+    }
+#else
+    return run<Value>(argc, argv);
+#endif
+}
@@ -0,0 +1,538 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Numbers.cpp - parsing and printing of numbers.                              *
+ ******************************************************************************/
+
+#include "rpn.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+using namespace std;
+using namespace RPN;
+
+#ifndef DOXYGEN_SKIP
+
+//! Tokens longer than this are copied to the heap before calling strtod().
+static const size_t BUFFER_SIZE = 64;
+
+//! Decimal digits that always fit in an unsigned long long.
+static const int MAX_DIGITS = 19;
+
+//! Powers of ten that are exact in an 80-bit long double. A type with a
+//! narrower mantissa only uses the ones it can represent exactly.
+static const long double POWERS[] =
+{
+    1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+//! Characters that can begin a number: digits, signs, the decimal point, and
+//! the first letters of "inf" and "nan".
+static bool canBeginNumber(char c)
+{
+    switch(c)
+    {
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+    case '+': case '-': case '.':
+    case 'i': case 'I': case 'n': case 'N':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool isHexDigit(char c)
+{
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+//! Case-insensitively compares [begin, end) with a lowercase word.
+static bool matches(const char *begin, const char *end, const char *word)
+{
+    for(; begin != end && *word; ++begin, ++word)
+        if((*begin | 0x20) != *word)
+            return false;
+
+    return begin == end && !*word;
+}
+
+static void toNumber(const char *s, char **stop, float& out)
+{
+    out = strtof(s, stop);
+}
+
+static void toNumber(const char *s, char **stop, double& out)
+{
+    out = strtod(s, stop);
+}
+
+static void toNumber(const char *s, char **stop, long double& out)
+{
+    out = strtold(s, stop);
+}
+
+//! Hands a token to the C library, which rounds correctly but needs a
+//! terminated string. The program never calls setlocale(), so the "C" locale
+//! and its '.' decimal point are always in effect.
+template <class T>
+static bool slowParse(const char *begin, const char *end, T& out)
+{
+    char buffer[BUFFER_SIZE];
+    string copy;
+    const char *s;
+    char *stop;
+    size_t length = end - begin;
+
+    if(length < BUFFER_SIZE)
+    {
+        memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+        s = buffer;
+    }
+    else
+    {
+        copy.assign(begin, end);
+        s = copy.c_str();
+    }
+
+    toNumber(s, &stop, out);
+
+    return stop == s + length;
+}
+
+//! Returns the largest power of ten that T represents exactly.
+template <class T>
+static int maxExactPower()
+{
+    const unsigned long long limit =
+        numeric_limits<T>::digits >= 64 ? ~0ULL
+                                        : 1ULL << numeric_limits<T>::digits;
+    unsigned long long five = 5;
+    int ret = 0;
+
+    while(five <= limit / 5)
+    {
+        five *= 5;
+        ++ret;
+    }
+
+    ret += 1;
+
+    return ret < (int)(sizeof(POWERS) / sizeof(*POWERS)) ?
+        ret : (int)(sizeof(POWERS) / sizeof(*POWERS)) - 1;
+}
+
+//! Returns true if the mantissa has more bits than T can hold exactly.
+template <class T>
+static bool tooWide(unsigned long long mantissa)
+{
+    const int digits = numeric_limits<T>::digits;
+
+    return digits < 64 && mantissa >> (digits < 64 ? digits : 0) != 0;
+}
+
+//! Parses "0b" binary integers. Anything wider than 64 bits is rewritten as a
+//! hexadecimal literal so that strtod() does the rounding.
+template <class T>
+static bool parseBinary(const char *begin, const char *end, bool negative,
+                        T& out)
+{
+    static const char hex[] = "0123456789abcdef";
+    unsigned long long n = 0;
+    const char *p;
+    string digits;
+    unsigned nibble = 0;
+    size_t bits;
+
+    if(begin == end)
+        return false;
+
+    for(p = begin; p != end; ++p)
+        if(*p != '0' && *p != '1')
+            return false;
+
+    // skip leading zeros, then see whether the rest fits.
+    while(begin != end && *begin == '0')
+        ++begin;
+    bits = end - begin;
+
+    if(bits <= 64)
+    {
+        for(p = begin; p != end; ++p)
+            n = n << 1 | (*p - '0');
+        out = (T)n;
+    }
+    else
+    {
+        digits = negative ? "-0x" : "0x";
+        for(p = begin; p != end; ++p)
+        {
+            nibble = nibble << 1 | (*p - '0');
+            if((end - p - 1) % 4 == 0)
+            {
+                digits += hex[nibble];
+                nibble = 0;
+            }
+        }
+        return slowParse(digits.data(), digits.data() + digits.size(), out);
+    }
+
+    if(negative)
+        out = -out;
+
+    return true;
+}
+
+//! Checks that a token is a hexadecimal integer or float before letting the C
+//! library convert it.
+static bool isHexLiteral(const char *p, const char *end)
+{
+    bool digits = false;
+
+    for(; p != end && isHexDigit(*p); ++p)
+        digits = true;
+    if(p != end && *p == '.')
+        for(++p; p != end && isHexDigit(*p); ++p)
+            digits = true;
+    if(!digits)
+        return false;
+    if(p != end && (*p == 'p' || *p == 'P'))
+    {
+        if(++p != end && (*p == '+' || *p == '-'))
+            ++p;
+        if(p == end || !isDigit(*p))
+            return false;
+        while(p != end && isDigit(*p))
+            ++p;
+    }
+
+    return p == end;
+}
+
+template <class T>
+static bool parse(const char *begin, const char *end, T& out)
+{
+    static const int maxPower = maxExactPower<T>();
+    const char *p = begin;
+    bool negative = false;
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0, explicitExponent = 0;
+    bool seenDigit = false, exact = true;
+    bool negativeExponent = false;
+    T power;
+
+    // almost every token that isn't a number is rejected right here.
+    if(p == end || !canBeginNumber(*p))
+        return false;
+
+    if(*p == '+' || *p == '-')
+    {
+        negative = *p == '-';
+        if(++p == end || !canBeginNumber(*p))
+            return false;
+    }
+
+    if(matches(p, end, "inf") || matches(p, end, "infinity"))
+    {
+        out = negative ? -numeric_limits<T>::infinity()
+                       :  numeric_limits<T>::infinity();
+        return true;
+    }
+    if(matches(p, end, "nan"))
+    {
+        out = numeric_limits<T>::quiet_NaN();
+        return true;
+    }
+
+    if(end - p > 2 && p[0] == '0')
+    {
+        if(p[1] == 'x' || p[1] == 'X')
+            return isHexLiteral(p + 2, end) && slowParse(begin, end, out);
+        if(p[1] == 'b' || p[1] == 'B')
+            return parseBinary(p + 2, end, negative, out);
+    }
+
+    // decimal digits, with an optional point.
+    for(; p != end && isDigit(*p); ++p)
+    {
+        seenDigit = true;
+        if(mantissa == 0 && *p == '0')
+            continue;
+        if(digits < MAX_DIGITS)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            ++digits;
+        }
+        else
+        {
+            exact = false;
+            ++exponent;
+        }
+    }
+    if(p != end && *p == '.')
+        for(++p; p != end && isDigit(*p); ++p)
+        {
+            seenDigit = true;
+            if(mantissa == 0 && *p == '0')
+            {
+                --exponent;
+                continue;
+            }
+            if(digits < MAX_DIGITS)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                ++digits;
+                --exponent;
+            }
+            else
+                exact = false;
+        }
+    if(!seenDigit)
+        return false;
+
+    // then an optional exponent.
+    if(p != end && (*p == 'e' || *p == 'E'))
+    {
+        if(++p != end && (*p == '+' || *p == '-'))
+            negativeExponent = *p++ == '-';
+        if(p == end || !isDigit(*p))
+            return false;
+        for(; p != end && isDigit(*p); ++p)
+            if(explicitExponent < 100000)
+                explicitExponent = explicitExponent * 10 + (*p - '0');
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if(p != end)
+        return false;
+
+    // if the mantissa and the power of ten are both exact, one multiplication
+    // or division rounds correctly. otherwise let the C library do it.
+    if(!exact || tooWide<T>(mantissa) ||
+       exponent > maxPower || exponent < -maxPower)
+        return slowParse(begin, end, out);
+
+    power = (T)POWERS[exponent < 0 ? -exponent : exponent];
+    out = exponent < 0 ? (T)mantissa / power : (T)mantissa * power;
+    if(negative)
+        out = -out;
+
+    return true;
+}
+
+static int format(char *s, size_t n, const char *spec, int precision,
+                  double v)
+{
+    char f[8] = "%.*";
+    strcat(f, spec);
+    return snprintf(s, n, f, precision, v);
+}
+
+static int format(char *s, size_t n, const char *spec, int precision,
+                  long double v)
+{
+    char f[8] = "%.*L";
+    strcat(f, spec);
+    return snprintf(s, n, f, precision, v);
+}
+
+//! Writes an integer that fits in a long long.
+static size_t formatInteger(char *s, long long n)
+{
+    char digits[24];
+    unsigned long long u = n < 0 ? -(unsigned long long)n : n;
+    size_t length = 0, i = 0;
+
+    do
+    {
+        digits[i++] = '0' + u % 10;
+        u /= 10;
+    }
+    while(u);
+
+    if(n < 0)
+        s[length++] = '-';
+    while(i)
+        s[length++] = digits[--i];
+    s[length] = '\0';
+
+    return length;
+}
+
+//! Tries more and more significant digits until the result reads back as the
+//! same value. Every number with up to digits10 digits survives a round trip,
+//! so starting there gives the shortest form, except for subnormals, which
+//! have fewer digits of precision. Integers that are small enough are written
+//! directly, and infinities and NaN have no digits to search for. A negative
+//! number is a minus sign and the digits of its magnitude, so negative
+//! integers and -0 take the same short cut.
+template <class T>
+static size_t shortest(char *s, T v)
+{
+    const int digits = numeric_limits<T>::digits10;
+    const int last = numeric_limits<T>::max_digits10;
+    T limit = (T)POWERS[digits < 18 ? digits : 18];
+    T back;
+    int first = digits, length = 0;
+    char *p = s;
+
+    if(isnan(v) || isinf(v))
+        return format(s, NUMBER_SIZE, "g", 1, v);
+    if(signbit(v))
+    {
+        *p++ = '-';
+        v = -v;
+    }
+    // only a value in range may be converted to long long.
+    if(v < limit && v == (long long)v)
+        return p - s + formatInteger(p, (long long)v);
+    if(v != 0 && v < numeric_limits<T>::min())
+        first = 1;
+
+    for(int precision = first; precision <= last; ++precision)
+    {
+        length = format(p, NUMBER_SIZE - (p - s), "g", precision, v);
+        if(!parse(p, p + length, back) || back == v)
+            break;
+    }
+
+    return p - s + length;
+}
+
+//! Prints a number in fixed notation. Huge numbers have thousands of digits
+//! that way, so those are written to the heap.
+template <class T>
+static void printFixed(T v)
+{
+    char s[NUMBER_SIZE];
+    int n = format(s, sizeof(s), "f", 6, v);
+    string big;
+
+    if(n >= (int)sizeof(s))
+    {
+        big.resize(n + 1);
+        format(&big[0], big.size(), "f", 6, v);
+        Port::Write(big.data(), n);
+    }
+    else
+        Port::Write(s, n);
+}
+
+#endif
+
+size_t RPN::formatNumber(char *s, float v)
+{
+    return format(s, NUMBER_SIZE, "g", 6, (double)v);
+}
+
+size_t RPN::formatNumber(char *s, double v)
+{
+    return format(s, NUMBER_SIZE, "g", 6, v);
+}
+
+size_t RPN::formatNumber(char *s, long double v)
+{
+    return format(s, NUMBER_SIZE, "g", 6, v);
+}
+
+size_t RPN::formatShortest(char *s, float v)
+{
+    return shortest(s, v);
+}
+
+size_t RPN::formatShortest(char *s, double v)
+{
+    return shortest(s, v);
+}
+
+size_t RPN::formatShortest(char *s, long double v)
+{
+    return shortest(s, v);
+}
+
+void RPN::PrintDetailed(float v)
+{
+    PrintDetailed((double)v);
+}
+
+void RPN::PrintDetailed(double v)
+{
+    printFixed(v);
+}
+
+void RPN::PrintDetailed(long double v)
+{
+    printFixed(v);
+}
+
+template <class T>
+void RPN::PrintItem(const BasicItem<T>& item, void (*printer)(T))
+{
+    const T* values = item.Data();
+
+    if(!item.IsArray())
+    {
+        printer(*values);
+        return;
+    }
+
+    Print("{ ");
+    for(size_t i = 0; i < item.Size(); ++i)
+    {
+        printer(values[i]);
+        Print(", ");
+    }
+    Print('}');
+}
+
+bool RPN::parseNumber(const char *begin, const char *end, float& out)
+{
+    return parse(begin, end, out);
+}
+
+bool RPN::parseNumber(const char *begin, const char *end, double& out)
+{
+    return parse(begin, end, out);
+}
+
+bool RPN::parseNumber(const char *begin, const char *end, long double& out)
+{
+    return parse(begin, end, out);
+}
+
+#define INSTANTIATE(T) \
+    template void RPN::PrintItem(const BasicItem<T>&, void (*)(T));
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+/*******************************************************************************
+ * Operation.h - header for the Operation class.                               *
+ ******************************************************************************/
+
+#ifndef RPN_OPERATION_H
+#define RPN_OPERATION_H
+
+#include <cstddef>
+#include "typedefs.h"
+
+namespace RPN
+{
+    //! An operator of one, two or three operands: the function applied to
+    //! single values, and the kernel that applies it element-wise to arrays.
+    //! A pure operator depends only on its operands, so it can be evaluated
+    //! ahead of time when they're known.
+    template <class T>
+    class BasicOperation
+    {
+    public:
+
+        //! The type of the function of a unary operator.
+        typedef T (*Unary)(T a);
+        //! The type of the function of a binary operator.
+        typedef T (*Binary)(T a, T b);
+        //! The type of the function of a ternary operator.
+        typedef T (*Ternary)(T a, T b, T c);
+        //! The type of the function applied element-wise to n tuples of
+        //! values. Each operand is stepped through by its step; a step of
+        //! zero repeats the same value for every tuple.
+        typedef void (*Kernel)(const T* const* operands, const size_t* steps,
+                               T* out, size_t n);
+
+    private:
+
+        unsigned arity;
+        bool     pure;
+        Unary    unary;
+        Binary   binary;
+        Ternary  ternary;
+        Kernel   kernel;
+
+    public:
+
+        //! Creates an empty operation.
+        BasicOperation()
+            : arity(0), pure(false), unary(NULL), binary(NULL), ternary(NULL),
+              kernel(NULL)
+        {
+        }
+
+        //! Creates an operation from its description. Only the function
+        //! matching the arity is used.
+        BasicOperation(unsigned arity, bool pure, Unary unary, Binary binary,
+                       Ternary ternary, Kernel kernel)
+            : arity(arity), pure(pure), unary(unary), binary(binary),
+              ternary(ternary), kernel(kernel)
+        {
+        }
+
+        //! Returns the number of operands.
+        unsigned Arity() const { return arity; }
+
+        //! Returns true if the result depends only on the operands.
+        bool Pure() const { return pure; }
+
+        //! Returns the function of a unary operation.
+        Unary GetUnary() const { return unary; }
+
+        //! Returns the function of a binary operation.
+        Binary GetBinary() const { return binary; }
+
+        //! Returns the function of a ternary operation.
+        Ternary GetTernary() const { return ternary; }
+
+        //! Applies a unary operation to a value.
+        T operator()(T a) const { return unary(a); }
+
+        //! Applies a binary operation to two values.
+        T operator()(T a, T b) const { return binary(a, b); }
+
+        //! Applies a ternary operation to three values.
+        T operator()(T a, T b, T c) const { return ternary(a, b, c); }
+
+        //! Applies the operation to n tuples of values.
+        void operator()(const T* const* operands, const size_t* steps,
+                        T* out, size_t n) const
+        {
+            kernel(operands, steps, out, n);
+        }
+    };
+}
+
+#endif
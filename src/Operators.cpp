@@ -29,88 +29,149 @@
  ******************************************************************************/
 
 #include "rpn.h"
-#include <cmath>
+#include "Operators.h"
 using namespace std;
 using namespace RPN;
 
 #ifndef DOXYGEN_SKIP
 
-static Value addition(Value a, Value b)
-{
-    return a + b;
-}
-
-static Value subtraction(Value a, Value b)
-{
-    return a - b;
-}
-
-static Value multiplication(Value a, Value b)
-{
-    return a * b;
-}
-
-static Value division(Value a, Value b)
-{
-    return a / b;
-}
-
-static Value power(Value a, Value b)
-{
-#ifdef RPN_DOUBLE
-    return pow(a, b);
-#elif  RPN_LONG_DOUBLE
-    return powl(a, b);
+// the kernels apply an operator to n tuples of values. each case gets its own
+// loop so that the compiler can vectorize it; on x86-64 GCC also builds AVX2
+// and AVX-512 versions and picks the best one the processor supports when the
+// program starts. long doubles are x87-only, so those loops stay scalar.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define KERNEL __attribute__((target_clones("avx512f", "avx2", "default"), \
+                              optimize("vect-cost-model=dynamic")))
+#else
+#define KERNEL
 #endif
-}
 
-static Value equals(Value a, Value b)
+template <class T, T (*F)(T)>
+KERNEL static void unaryKernel(const T* const* operands, const size_t*,
+                               T* out, size_t n)
 {
-    return a == b ? 1 : 0;
-}
+    const T* a = operands[0];
 
-static Value modulo(Value a, Value b)
-{
-    return (long)a % (long)b;
+    for(size_t i = 0; i < n; ++i)
+        out[i] = F(a[i]);
 }
 
-static Value _xor(Value a, Value b)
+template <class T, T (*F)(T, T)>
+KERNEL static void binaryKernel(const T* const* operands, const size_t* steps,
+                                T* out, size_t n)
 {
-    return (long)a ^ (long)b;
+    const T* a = operands[0];
+    const T* b = operands[1];
+    size_t i;
+
+    if(steps[0] && steps[1])
+        for(i = 0; i < n; ++i)
+            out[i] = F(a[i], b[i]);
+    else if(steps[0])
+    {
+        T y = *b;
+        for(i = 0; i < n; ++i)
+            out[i] = F(a[i], y);
+    }
+    else
+    {
+        T x = *a;
+        for(i = 0; i < n; ++i)
+            out[i] = F(x, b[i]);
+    }
 }
 
-static Value _and(Value a, Value b)
+// three operands have too many combinations of arrays and single values to
+// give each its own loop, so only the common all-arrays case gets one.
+template <class T, T (*F)(T, T, T)>
+KERNEL static void ternaryKernel(const T* const* operands,
+                                 const size_t* steps, T* out, size_t n)
 {
-    return (long)a & (long)b;
+    const T* a = operands[0];
+    const T* b = operands[1];
+    const T* c = operands[2];
+    size_t i;
+
+    if(steps[0] && steps[1] && steps[2])
+        for(i = 0; i < n; ++i)
+            out[i] = F(a[i], b[i], c[i]);
+    else
+        for(i = 0; i < n; ++i)
+            out[i] = F(a[i * steps[0]], b[i * steps[1]], c[i * steps[2]]);
 }
 
-static Value _or(Value a, Value b)
-{
-    return (long)a | (long)b;
-}
+#endif
 
-static Value _log(Value b, Value e)
+//! Describes a unary operator in the table below.
+#define UNARY(name, f) \
+    { name, 1, true, Operators::f<T>, NULL, NULL, \
+      unaryKernel<T, Operators::f<T> >, #f }
+//! Describes a binary operator in the table below.
+#define BINARY(name, f) \
+    { name, 2, true, NULL, Operators::f<T>, NULL, \
+      binaryKernel<T, Operators::f<T> >, #f }
+//! Describes a ternary operator in the table below.
+#define TERNARY(name, f) \
+    { name, 3, true, NULL, NULL, Operators::f<T>, \
+      ternaryKernel<T, Operators::f<T> >, #f }
+
+template <class T>
+const typename BasicCalculator<T>::BuiltinOperator*
+BasicCalculator<T>::builtinOperators(size_t& count)
 {
-    return log(e) / log(b);
+    // must be sorted by name.
+    static constexpr BuiltinOperator operators[] =
+    {
+        BINARY ("%",      modulo),
+        BINARY ("&",      _and),
+        BINARY ("*",      multiplication),
+        BINARY ("**",     power),
+        BINARY ("+",      addition),
+        BINARY ("-",      subtraction),
+        BINARY ("/",      division),
+        BINARY ("=",      equals),
+        BINARY ("^",      _xor),
+        UNARY  ("abs",    _abs),
+        UNARY  ("ceil",   _ceil),
+        TERNARY("clamp",  _clamp),
+        UNARY  ("cos",    _cos),
+        UNARY  ("exp",    _exp),
+        UNARY  ("floor",  _floor),
+        TERNARY("fma",    _fma),
+        UNARY  ("ln",     _ln),
+        BINARY ("log",    _log),
+        UNARY  ("round",  _round),
+        TERNARY("select", _select),
+        UNARY  ("sin",    _sin),
+        UNARY  ("sqrt",   _sqrt),
+        UNARY  ("tan",    _tan),
+        BINARY ("|",      _or)
+    };
+    static_assert(sortedByName(operators), "operators must be sorted by name");
+
+    count = sizeof(operators) / sizeof(*operators);
+    return operators;
 }
 
-#endif
-
-Operators RPN::defaultOperators()
+template <class T>
+const typename BasicCalculator<T>::BuiltinOperator*
+BasicCalculator<T>::derivedOperators(size_t& count)
 {
-    Operators ret;
-
-    ret["+"]   = addition;
-    ret["-"]   = subtraction;
-    ret["*"]   = multiplication;
-    ret["/"]   = division;
-    ret["**"]  = power;
-    ret["="]   = equals;
-    ret["%"]   = modulo;
-    ret["^"]   = _xor;
-    ret["&"]   = _and;
-    ret["|"]   = _or;
-    ret["log"] = _log;
-
-    return ret;
+    // must be sorted by name.
+    static constexpr BuiltinOperator operators[] =
+    {
+        BINARY ("**",     integerPower),
+        UNARY  ("square", square)
+    };
+    static_assert(sortedByName(operators), "operators must be sorted by name");
+
+    count = sizeof(operators) / sizeof(*operators);
+    return operators;
 }
+
+#define INSTANTIATE(T) \
+    template const BasicCalculator<T>::BuiltinOperator* \
+    BasicCalculator<T>::builtinOperators(size_t&); \
+    template const BasicCalculator<T>::BuiltinOperator* \
+    BasicCalculator<T>::derivedOperators(size_t&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
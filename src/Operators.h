@@ -0,0 +1,224 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Operators.h - the functions of the built-in operators.                      *
+ ******************************************************************************/
+
+#ifndef RPN_OPERATORS_H
+#define RPN_OPERATORS_H
+
+#include <cmath>
+
+// the functions can be evaluated at compile time where the language allows it,
+// as by Eval.h.
+#if __cplusplus >= 201103L
+#define RPN_CONSTEXPR constexpr
+#else
+#define RPN_CONSTEXPR inline
+#endif
+
+namespace RPN
+{
+    //! The functions of the built-in operators. They depend on nothing else
+    //! in the program, so code written by --emit-cpp includes this header on
+    //! its own to get exactly the calculator's arithmetic.
+    namespace Operators
+    {
+        template <class T>
+        RPN_CONSTEXPR T addition(T a, T b)
+        {
+            return a + b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T subtraction(T a, T b)
+        {
+            return a - b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T multiplication(T a, T b)
+        {
+            return a * b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T division(T a, T b)
+        {
+            return a / b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T power(T a, T b)
+        {
+            return std::pow(a, b);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T equals(T a, T b)
+        {
+            return a == b ? 1 : 0;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T modulo(T a, T b)
+        {
+            return (long)a % (long)b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _xor(T a, T b)
+        {
+            return (long)a ^ (long)b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _and(T a, T b)
+        {
+            return (long)a & (long)b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _or(T a, T b)
+        {
+            return (long)a | (long)b;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _log(T b, T e)
+        {
+            return std::log(e) / std::log(b);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _abs(T a)
+        {
+            return std::fabs(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _ceil(T a)
+        {
+            return std::ceil(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _cos(T a)
+        {
+            return std::cos(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _exp(T a)
+        {
+            return std::exp(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _floor(T a)
+        {
+            return std::floor(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _ln(T a)
+        {
+            return std::log(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _round(T a)
+        {
+            return std::round(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _sin(T a)
+        {
+            return std::sin(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _sqrt(T a)
+        {
+            return std::sqrt(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _tan(T a)
+        {
+            return std::tan(a);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _clamp(T x, T low, T high)
+        {
+            return x < low ? low : high < x ? high : x;
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _fma(T a, T b, T c)
+        {
+            return std::fma(a, b, c);
+        }
+
+        template <class T>
+        RPN_CONSTEXPR T _select(T condition, T a, T b)
+        {
+            return condition != 0 ? a : b;
+        }
+
+        // the optimizer puts these in place of some uses of power().
+
+        template <class T>
+        RPN_CONSTEXPR T square(T a)
+        {
+            return a * a;
+        }
+
+        // raises a to the whole power b by repeated squaring, which takes a
+        // few multiplications instead of a call to pow(). the result can
+        // differ from pow()'s in the last place.
+        template <class T>
+        inline T integerPower(T a, T b)
+        {
+            unsigned long n = (unsigned long)(b < 0 ? -b : b);
+            T result = 1;
+
+            for(; n; n >>= 1)
+            {
+                if(n & 1)
+                    result *= a;
+                a *= a;
+            }
+
+            return b < 0 ? 1 / result : result;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,298 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Optimizer.cpp - the optimizer of compiled programs.                         *
+ ******************************************************************************/
+
+#include "rpn.h"
+#include "Operators.h"
+#include <cmath>
+using namespace std;
+using namespace RPN;
+
+// returns true if two numbers are the same, telling 0 and -0 apart.
+template <class T>
+static bool sameNumber(T a, T b)
+{
+    return a == b && (a != 0 || signbit(a) == signbit(b));
+}
+
+// returns true if two instructions always do the same thing.
+template <class T>
+static bool sameInstruction(const BasicInstruction<T>& a,
+                            const BasicInstruction<T>& b)
+{
+    typedef BasicInstruction<T> Instruction;
+
+    if(a.Code() != b.Code())
+        return false;
+
+    switch(a.Code())
+    {
+    case Instruction::PushLiteral:
+        return sameNumber(a.Number(), b.Number());
+
+    case Instruction::Variable:
+        return a.Slot() == b.Slot();
+
+    case Instruction::CallOperator:
+        return a.GetOperation().Arity() == b.GetOperation().Arity() &&
+               a.GetOperation().GetUnary() == b.GetOperation().GetUnary() &&
+               a.GetOperation().GetBinary() == b.GetOperation().GetBinary() &&
+               a.GetOperation().GetTernary() == b.GetOperation().GetTernary();
+
+    default:
+        return false;
+    }
+}
+
+// returns where the expression ending just before end begins: a run of
+// literals, variables and pure operators that leaves one value without using
+// any from before it. returns end if there's no such run.
+template <class T>
+static size_t expressionStart(const vector<BasicInstruction<T> >& program,
+                              size_t end)
+{
+    typedef BasicInstruction<T> Instruction;
+    size_t needed = 1;
+
+    for(size_t i = end; i-- > 0;)
+    {
+        const Instruction& ins = program[i];
+
+        if(ins.Code() == Instruction::CallOperator &&
+           ins.GetOperation().Pure())
+            needed += ins.GetOperation().Arity() - 1;
+        else if(ins.Code() == Instruction::PushLiteral ||
+                ins.Code() == Instruction::Variable)
+        {
+            if(--needed == 0)
+                return i;
+        }
+        else
+            break;
+    }
+
+    return end;
+}
+
+// the optimizer works through the program once, building the new one as it
+// goes. for each instruction it keeps how many of the values pushed so far
+// are certain to still be on the stack, since an operator only certainly
+// applies when its operands are; otherwise it might act as a variable.
+//
+// a variable is certain to be set, and so only be loaded, if it was set when
+// the program was compiled or the program has already used it, as long as
+// no command has run since; unset makes the calculator forget its programs.
+//
+// it also keeps how many of those values are certain to be scalars, and
+// which variables are. an operator given arrays of different lengths acts
+// as a variable too, so only expressions of scalars can be shared.
+template <class T>
+typename BasicCalculator<T>::Instructions
+BasicCalculator<T>::Optimize(const Instructions& program)
+{
+    size_t numDerived;
+    const BuiltinOperator* derived = derivedOperators(numDerived);
+    const BuiltinOperator* square = findBuiltin(derived, numDerived,
+                                                "square");
+    const BuiltinOperator* integerPower = findBuiltin(derived, numDerived,
+                                                      "**");
+    const BuiltinCommand* command = Lookup("dup").command;
+    Command dup(command->function, command->args);
+    Instructions optimized;
+    vector<size_t> depths;
+    vector<size_t> scalars;
+    vector<size_t> known(slots.size());
+    vector<bool> scalar(slots.size());
+    bool commands = false;
+
+    optimized.reserve(program.size());
+    depths.reserve(program.size());
+    scalars.reserve(program.size());
+
+    // known holds one more than where each variable was first used, or 0 if
+    // it was set beforehand.
+    for(size_t i = 0; i < slots.size(); ++i)
+    {
+        known[i] = slots[i].set ? 0 : NO_SLOT;
+        scalar[i] = slots[i].set && !slots[i].value.IsArray();
+    }
+
+    for(size_t i = 0; i < program.size(); ++i)
+    {
+        Instruction ins = program[i];
+        size_t n = optimized.size();
+        size_t depth = n ? depths.back() : 0;
+        size_t top = n ? scalars.back() : 0;
+
+        switch(ins.Code())
+        {
+        case Instruction::PushLiteral:
+            depth += 1;
+            top += 1;
+            break;
+
+        // the values of variables that were set when the program was
+        // compiled are folded in, including the predefined ones.
+        case Instruction::Variable:
+        {
+            size_t variable = ins.Slot();
+            const Slot& slot = slots[variable];
+
+            if(!commands && slot.set && !slot.value.IsArray())
+                ins = Instruction::Literal(slot.value.Scalar());
+            if(known[variable] != NO_SLOT)
+            {
+                depth += 1;
+                top = scalar[variable] ? top + 1 : 0;
+            }
+            else
+            {
+                known[variable] = n + 1;
+                scalar[variable] = !commands && top > 0;
+            }
+            break;
+        }
+
+        case Instruction::CallCommand:
+            commands = true;
+            for(size_t j = 0; j < known.size(); ++j)
+            {
+                known[j] = NO_SLOT;
+                scalar[j] = false;
+            }
+            depth = 0;
+            top = 0;
+            break;
+
+        case Instruction::CallOperator:
+        {
+            const Operation& op = ins.GetOperation();
+            unsigned arity = op.Arity();
+            bool literals = op.Pure() && n >= arity;
+
+            for(size_t j = n - arity; literals && j < n; ++j)
+                literals = optimized[j].Code() == Instruction::PushLiteral;
+
+            // an operator of literals is done now.
+            if(literals)
+            {
+                T a = optimized[n - arity].Number();
+
+                if(arity == 1)
+                    a = op(a);
+                else if(arity == 2)
+                    a = op(a, optimized[n - 1].Number());
+                else
+                    a = op(a, optimized[n - 2].Number(),
+                           optimized[n - 1].Number());
+
+                optimized.erase(optimized.end() - arity, optimized.end());
+                depths.resize(n - arity);
+                scalars.resize(n - arity);
+                ins = Instruction::Literal(a);
+                depth = (n > arity ? depths.back() : 0) + 1;
+                top = (n > arity ? scalars.back() : 0) + 1;
+                break;
+            }
+
+            // a whole power is done by multiplying, and the square of a
+            // value that's certain to be there by a single multiplication.
+            if(op.GetBinary() == Operators::power<T> && n &&
+               optimized[n - 1].Code() == Instruction::PushLiteral)
+            {
+                T power = optimized[n - 1].Number();
+
+                if(power == 2 && depth >= 2)
+                {
+                    optimized.pop_back();
+                    depths.pop_back();
+                    scalars.pop_back();
+                    depth = depths.back();
+                    top = scalars.back();
+                    ins = Instruction::Oper(ins.Name(),
+                        Operation(1, true, square->unary, NULL, NULL,
+                                  square->kernel), ins.Slot());
+                    break;
+                }
+
+                if(power == floor(power) && fabs(power) <= MAX_SQUARED_POWER)
+                    ins = Instruction::Oper(ins.Name(),
+                        Operation(2, true, NULL, integerPower->binary, NULL,
+                                  integerPower->kernel), ins.Slot());
+            }
+
+            depth = depth >= arity ? depth - arity + 1 : 0;
+            top = top >= arity ? top - arity + 1 : 0;
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        optimized.push_back(ins);
+        depths.push_back(depth);
+        scalars.push_back(top);
+
+        // an expression with an operator that's repeated right after itself
+        // is replaced by a dup of its value, as long as its variables were
+        // already set before it and are scalars.
+        size_t end = optimized.size();
+        size_t second = expressionStart(optimized, end);
+        size_t first = expressionStart(optimized, second);
+        bool same = first < second && second - first == end - second &&
+                    end - second > 1;
+
+        for(size_t j = 0; same && j < end - second; ++j)
+            same = sameInstruction(optimized[first + j],
+                                   optimized[second + j]);
+        for(size_t j = first; same && j < second; ++j)
+            if(optimized[j].Code() == Instruction::Variable)
+                same = known[optimized[j].Slot()] <= first &&
+                       scalar[optimized[j].Slot()];
+
+        if(same)
+        {
+            optimized.erase(optimized.begin() + second, optimized.end());
+            depths.resize(second);
+            depths.push_back(depths.back() + 1);
+            scalars.resize(second);
+            scalars.push_back(scalars.back() + 1);
+            optimized.push_back(Instruction::Cmd("dup", dup,
+                                                 Instruction::NO_ARGUMENTS));
+        }
+    }
+
+    return optimized;
+}
+
+#define INSTANTIATE(T) \
+    template BasicCalculator<T>::Instructions \
+    BasicCalculator<T>::Optimize(const BasicCalculator<T>::Instructions&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Stack.h - header for the Stack class.                                       *
+ ******************************************************************************/
+
+#ifndef RPN_STACK_H
+#define RPN_STACK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "typedefs.h"
+#include "Item.h"
+
+namespace RPN
+{
+    //! The stack of values operated on by the calculator. Items are stored in
+    //! fixed-size chunks with the top at the end. Copies share their chunks,
+    //! and a chunk is only copied when one of the stacks sharing it writes to
+    //! it, so saving a stack in the history costs one pointer per chunk.
+    template <class T>
+    class BasicStack
+    {
+    public:
+
+        //! The type of the items.
+        typedef BasicItem<T> Item;
+
+    private:
+
+        //! How many items each chunk holds.
+        static const size_t CHUNK_SIZE = 256;
+
+        //! A reference-counted block of items.
+        struct Chunk
+        {
+            size_t refs;
+            Item   items[CHUNK_SIZE];
+
+            Chunk() : refs(1), items() {}
+        };
+
+        std::vector<Chunk*> chunks;
+        size_t              count;
+
+        //! Returns how many chunks hold the items.
+        size_t UsedChunks() const
+        {
+            return (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        }
+
+        //! Drops a reference to a chunk, freeing it if it was the last.
+        static void Release(Chunk* chunk)
+        {
+            if(--chunk->refs == 0)
+                delete chunk;
+        }
+
+        //! Returns a chunk that this stack can write to, copying it first if
+        //! it's shared.
+        Chunk* Own(size_t n)
+        {
+            Chunk*& chunk = chunks[n];
+
+            if(chunk->refs > 1)
+            {
+                Chunk* copy = new Chunk(*chunk);
+                copy->refs = 1;
+                --chunk->refs;
+                chunk = copy;
+            }
+
+            return chunk;
+        }
+
+        //! Shares the chunks holding another stack's items.
+        void Share(const BasicStack& other)
+        {
+            chunks.assign(other.chunks.begin(),
+                          other.chunks.begin() + other.UsedChunks());
+            count = other.count;
+            for(size_t i = 0; i < chunks.size(); ++i)
+                ++chunks[i]->refs;
+        }
+
+        //! Drops all chunks.
+        void Clear()
+        {
+            for(size_t i = 0; i < chunks.size(); ++i)
+                Release(chunks[i]);
+            chunks.clear();
+            count = 0;
+        }
+
+    public:
+
+        //! Creates an empty stack.
+        BasicStack()
+            : chunks(), count(0)
+        {
+        }
+
+        //! Copies another stack, sharing its chunks.
+        BasicStack(const BasicStack& other)
+            : chunks(), count(0)
+        {
+            Share(other);
+        }
+
+        ~BasicStack()
+        {
+            Clear();
+        }
+
+        BasicStack& operator=(const BasicStack& other)
+        {
+            if(this != &other)
+            {
+                Clear();
+                Share(other);
+            }
+
+            return *this;
+        }
+
+        //! Returns the number of items.
+        size_t size() const { return count; }
+
+        //! Returns true if there are no items.
+        bool empty() const { return count == 0; }
+
+        //! Returns the item at an index, counting from the bottom.
+        const Item& operator[](size_t i) const
+        {
+            return chunks[i / CHUNK_SIZE]->items[i % CHUNK_SIZE];
+        }
+
+        //! Returns a writable item at an index, counting from the bottom.
+        Item& operator[](size_t i)
+        {
+            return Own(i / CHUNK_SIZE)->items[i % CHUNK_SIZE];
+        }
+
+        //! Returns the topmost item. The stack must not be empty.
+        const Item& top() const { return (*this)[count - 1]; }
+        Item& top() { return (*this)[count - 1]; }
+
+        //! Pushes an item onto the top. Pushing an item of the same stack is
+        //! safe, since chunks never move and a shared chunk that's copied is
+        //! still held by the other stacks.
+        void push(const Item& v)
+        {
+            if(count == chunks.size() * CHUNK_SIZE)
+            {
+                Chunk* chunk = new Chunk;
+                chunks.push_back(chunk);
+            }
+            (*this)[count++] = v;
+        }
+
+        //! Removes the topmost item. The stack must not be empty. Emptied
+        //! chunks are kept for the next push, but the item is reset so that
+        //! an array doesn't outlive it.
+        void pop()
+        {
+            const BasicStack& self = *this;
+            if(self.top().IsArray())
+                top() = Item();
+            --count;
+        }
+
+        //! Removes all items, keeping the chunks for the next push.
+        void clear()
+        {
+            const BasicStack& self = *this;
+            for(size_t i = 0; i < count; ++i)
+                if(self[i].IsArray())
+                    (*this)[i] = Item();
+            count = 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Statistics.h - counts and times what programs do.                           *
+ ******************************************************************************/
+
+#ifndef RPN_STATISTICS_H
+#define RPN_STATISTICS_H
+
+// Only used when RPN_STATS is defined, so that the calculator doesn't pay
+// for counting otherwise.
+#ifdef RPN_STATS
+
+#include <map>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RPN_CYCLE_COUNTER
+#else
+#include <ctime>
+#endif
+
+namespace RPN
+{
+    //! Returns a timestamp in cycles, or in nanoseconds where there's no
+    //! cycle counter to read.
+    inline unsigned long long timestamp()
+    {
+#ifdef RPN_CYCLE_COUNTER
+        return __rdtsc();
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+    }
+
+    //! How often a token ran, and for how long in all.
+    struct Statistic
+    {
+        //! What the token did: "literal", "operator", "command", "load" or
+        //! "store".
+        const char*        kind;
+        std::string        name;
+        unsigned long      count;
+        unsigned long long time;
+    };
+
+    //! The statistics of every token a calculator has run. Each is found by
+    //! its row when a line is compiled, so running it only adds to the row.
+    class Statistics
+    {
+        std::vector<Statistic>        rows;
+        std::map<std::string, size_t> index;
+
+    public:
+
+        Statistics() : rows(), index() {}
+
+        //! Returns the row of a token, adding one if it's new.
+        size_t Row(const char* kind, const std::string& name)
+        {
+            std::string key = std::string(kind) + ' ' + name;
+            std::map<std::string, size_t>::iterator found = index.find(key);
+            Statistic row = { kind, name, 0, 0 };
+
+            if(found != index.end())
+                return found->second;
+
+            rows.push_back(row);
+            return index[key] = rows.size() - 1;
+        }
+
+        //! Counts a run of a row's token that took time.
+        void Add(size_t row, unsigned long long time)
+        {
+            ++rows[row].count;
+            rows[row].time += time;
+        }
+
+        //! Returns the rows in the order their tokens were first seen.
+        const std::vector<Statistic>& Rows() const { return rows; }
+
+        //! Returns the unit of the times, "cycles" or "ns".
+        static const char* Unit()
+        {
+#ifdef RPN_CYCLE_COUNTER
+            return "cycles";
+#else
+            return "ns";
+#endif
+        }
+    };
+}
+
+#endif
+#endif
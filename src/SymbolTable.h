@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+/*******************************************************************************
+ * SymbolTable.h - header for the SymbolTable class.                           *
+ ******************************************************************************/
+
+#ifndef RPN_SYMBOLTABLE_H
+#define RPN_SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace RPN
+{
+    //! A hash table from names to values, looked up by pointer and length so
+    //! that tokens don't need to be copied first. Names are never removed.
+    template <class V>
+    class SymbolTable
+    {
+        //! A name and its value.
+        struct Entry
+        {
+            size_t      hash;
+            std::string name;
+            V           value;
+            bool        used;
+
+            Entry() : hash(0), name(), value(), used(false) {}
+        };
+
+        std::vector<Entry> entries;
+        size_t             count;
+
+        //! Hashes a name with FNV-1a.
+        static size_t Hash(const char* s, size_t n)
+        {
+            size_t h = (size_t)2166136261UL;
+
+            while(n--)
+                h = (h ^ (unsigned char)*s++) * 16777619;
+
+            return h;
+        }
+
+        //! Returns the index of the entry holding a name, or of the empty
+        //! entry where it would go.
+        size_t Probe(const char* s, size_t n, size_t hash) const
+        {
+            size_t mask = entries.size() - 1;
+            size_t i = hash & mask;
+
+            while(entries[i].used &&
+                  (entries[i].hash != hash || entries[i].name.size() != n ||
+                   std::memcmp(entries[i].name.data(), s, n) != 0))
+                i = (i + 1) & mask;
+
+            return i;
+        }
+
+        //! Doubles the number of entries, rehashing the names.
+        void Grow()
+        {
+            std::vector<Entry> old(entries.empty() ? 16 : entries.size() * 2);
+            size_t i;
+
+            old.swap(entries);
+            for(i = 0; i < old.size(); ++i)
+                if(old[i].used)
+                {
+                    const std::string& name = old[i].name;
+                    Entry& entry = entries[Probe(name.data(), name.size(),
+                                                 old[i].hash)];
+                    entry.hash = old[i].hash;
+                    entry.name.swap(old[i].name);
+                    entry.value = old[i].value;
+                    entry.used = true;
+                }
+        }
+
+    public:
+
+        //! Creates an empty table. Nothing is allocated until a name is added.
+        SymbolTable()
+            : entries(), count(0)
+        {
+        }
+
+        //! Returns the value of a name, or NULL if it isn't in the table.
+        V* Find(const char* s, size_t n)
+        {
+            if(entries.empty())
+                return NULL;
+
+            Entry& entry = entries[Probe(s, n, Hash(s, n))];
+            return entry.used ? &entry.value : NULL;
+        }
+
+        //! Returns the value of a name, or NULL if it isn't in the table.
+        V* Find(const std::string& name)
+        {
+            return Find(name.data(), name.size());
+        }
+
+        //! Returns the value of a name, adding the name with a default value
+        //! first if it isn't in the table. The reference is only good until
+        //! the next name is added.
+        V& Intern(const char* s, size_t n)
+        {
+            size_t hash = Hash(s, n);
+            size_t i;
+
+            if(entries.empty())
+                Grow();
+            i = Probe(s, n, hash);
+
+            if(!entries[i].used)
+            {
+                // keep the table at most three quarters full.
+                if((count + 1) * 4 > entries.size() * 3)
+                {
+                    Grow();
+                    i = Probe(s, n, hash);
+                }
+
+                entries[i].hash = hash;
+                entries[i].name.assign(s, n);
+                entries[i].used = true;
+                ++count;
+            }
+
+            return entries[i].value;
+        }
+
+        //! Returns the value of a name, adding it if it isn't in the table.
+        V& Intern(const std::string& name)
+        {
+            return Intern(name.data(), name.size());
+        }
+
+        //! Returns the number of names in the table.
+        size_t Size() const { return count; }
+    };
+}
+
+#endif
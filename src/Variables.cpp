@@ -32,25 +32,34 @@
 using namespace std;
 using namespace RPN;
 
-Variables RPN::defaultVariables()
+template <class T>
+const typename BasicCalculator<T>::BuiltinVariable*
+BasicCalculator<T>::builtinVariables(size_t& count)
 {
-    Variables ret;
+    // must be sorted by name.
+    static constexpr BuiltinVariable variables[] =
+    {
+        { "E",       2.718281828L             },
+        { "GB",      1000 * 1000 * 1000       },
+        { "GiB",     1024 * 1024 * 1024       },
+        { "Gib",     1024 * 1024 * 1024 / 8   },
+        { "HOURS",   60 * 60                  },
+        { "KB",      1000                     },
+        { "KiB",     1024                     },
+        { "Kib",     1024 / 8                 },
+        { "MB",      1000 * 1000              },
+        { "MINUTES", 60                       },
+        { "MiB",     1024 * 1024              },
+        { "Mib",     1024 * 1024 / 8          },
+        { "PI",      3.141592654L             }
+    };
+    static_assert(sortedByName(variables), "variables must be sorted by name");
 
-    ret["E"]  = 2.718281828;
-    ret["PI"] = 3.141592654;
-
-    ret["KB"] = 1000;
-    ret["MB"] = 1000 * 1000;
-    ret["GB"] = 1000 * 1000 * 1000;
-    ret["KiB"] = 1024;
-    ret["MiB"] = 1024 * 1024;
-    ret["GiB"] = 1024 * 1024 * 1024;
-    ret["Kib"] = 1024 / 8;
-    ret["Mib"] = 1024 * 1024 / 8;
-    ret["Gib"] = 1024 * 1024 * 1024 / 8;
-
-    ret["MINUTES"] = 60;
-    ret["HOURS"]   = 60 * 60;
-
-    return ret;
+    count = sizeof(variables) / sizeof(*variables);
+    return variables;
 }
+
+#define INSTANTIATE(T) \
+    template const BasicCalculator<T>::BuiltinVariable* \
+    BasicCalculator<T>::builtinVariables(size_t&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
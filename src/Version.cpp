@@ -1,13 +1,18 @@
 /* This version of the getVersion() function is used for platforms that
- * can't get extra version information from a Git repository.
+ * can't get extra version information from a Git repository, or that pass it
+ * in through GIT_BUILD instead.
  */
 
-#ifdef RPN_GITLESS
+#if defined(RPN_GITLESS) || defined(GIT_BUILD)
 namespace RPN
 {
 	const char *getVersion()
 	{
+#ifdef GIT_BUILD
+		return GIT_BUILD;
+#else
 		return "gitless";
+#endif
 	}
 }
 #endif
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Bench.h - the microbenchmark harness.                                 *
+ ******************************************************************************/
+
+#ifndef RPN_BENCH_H
+#define RPN_BENCH_H
+
+#include <string>
+
+namespace RPN
+{
+    namespace Bench
+    {
+        //! Returns a monotonic time in nanoseconds.
+        double now();
+
+        //! Records how many nanoseconds an iteration of a benchmark took.
+        void record(const std::string& name, double ns,
+                    unsigned long iterations);
+
+        //! Returns true if the benchmarks of that name should be run.
+        bool selected(const std::string& name);
+
+        //! Times work(n), which must do n iterations of a benchmark,
+        //! doubling n until a run takes long enough to trust. The best of a
+        //! few runs at that size is recorded.
+        template <class Work>
+        void measure(const std::string& name, Work& work)
+        {
+            const double enough = 2e7;
+            unsigned long n = 1;
+            double time, best;
+
+            if(!selected(name))
+                return;
+
+            for(;;)
+            {
+                time = now();
+                work(n);
+                time = now() - time;
+                if(time >= enough)
+                    break;
+                n *= time > enough / 64 ? 2 : 16;
+            }
+
+            best = time;
+            for(int i = 0; i < 2; ++i)
+            {
+                time = now();
+                work(n);
+                time = now() - time;
+                if(time < best)
+                    best = time;
+            }
+
+            record(name, best / n, n);
+        }
+
+        //! Benchmarks tokenizing and parsing literals.
+        void numbers();
+        //! Benchmarks the operators, commands, history and evaluation.
+        void calculator();
+        //! Benchmarks printing the stack.
+        void printing();
+    }
+}
+
+#endif
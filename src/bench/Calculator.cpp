@@ -0,0 +1,263 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Calculator.cpp - benchmarks the calculator.                           *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Bench.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+using namespace RPN;
+using namespace RPN::Bench;
+using namespace std;
+
+typedef BasicCalculator<Value> Calculator;
+
+//! How many different operands each operator is applied to.
+static const size_t OPERANDS = 256;
+
+//! Returns a built-in command.
+static Calculator::Command command(const char* name)
+{
+    size_t count;
+    const Calculator::BuiltinCommand* commands;
+    const Calculator::BuiltinCommand* found;
+
+    commands = Calculator::builtinCommands(count);
+    found = findBuiltin(commands, count, name);
+    return Calculator::Command(found->function, found->args);
+}
+
+//! Applies an operator straight to numbers, without a calculator.
+struct ApplyOperator
+{
+    Calculator::Operation operation;
+    vector<Value>         a, b, c;
+    Value                 sink;
+
+    ApplyOperator(const Calculator::BuiltinOperator& op)
+        : operation(op.arity, op.pure, op.unary, op.binary, op.ternary,
+                    op.kernel),
+          a(OPERANDS), b(OPERANDS), c(OPERANDS), sink(0)
+    {
+        for(size_t i = 0; i < OPERANDS; ++i)
+        {
+            a[i] = (Value)(i % 17) / 4 + 1;
+            b[i] = (Value)(i % 5) / 2 + 1;
+            c[i] = (Value)(i % 3);
+        }
+    }
+
+    void operator()(unsigned long n)
+    {
+        size_t j;
+
+        for(unsigned long i = 0; i < n; ++i)
+        {
+            j = i % OPERANDS;
+            if(operation.Arity() == 1)
+                sink += operation(a[j]);
+            else if(operation.Arity() == 2)
+                sink += operation(a[j], b[j]);
+            else
+                sink += operation(a[j], b[j], c[j]);
+        }
+    }
+};
+
+//! Performs one or two commands through Command::Perform, in order, n
+//! times.
+struct PerformCommands
+{
+    Calculator&                 calculator;
+    vector<Calculator::Command> commands;
+    vector<string>              args;
+
+    PerformCommands(Calculator& calculator, const char* first,
+                    const char* second = NULL)
+        : calculator(calculator), commands(), args()
+    {
+        commands.push_back(command(first));
+        if(second)
+            commands.push_back(command(second));
+    }
+
+    void operator()(unsigned long n)
+    {
+        for(unsigned long i = 0; i < n; ++i)
+            for(size_t j = 0; j < commands.size(); ++j)
+                commands[j].Perform(calculator, args);
+    }
+};
+
+//! Evaluates lines in turn.
+struct Evaluate
+{
+    Calculator&    calculator;
+    vector<string> lines;
+
+    Evaluate(Calculator& calculator, const vector<string>& lines)
+        : calculator(calculator), lines(lines)
+    {
+    }
+
+    void operator()(unsigned long n)
+    {
+        for(unsigned long i = 0; i < n; ++i)
+            calculator.Eval(lines[i % lines.size()]);
+    }
+};
+
+//! Returns a line that pushes n numbers.
+static string pushes(size_t n)
+{
+    string ret;
+
+    for(size_t i = 0; i < n; ++i)
+        ret += "1.5 ";
+
+    return ret;
+}
+
+//! Returns the name of a benchmark with a number in it.
+static string numbered(const char* prefix, size_t n)
+{
+    char s[32];
+
+    snprintf(s, sizeof(s), "%lu", (unsigned long)n);
+    return prefix + string(s);
+}
+
+static void operators()
+{
+    size_t count;
+    const Calculator::BuiltinOperator* ops;
+
+    ops = Calculator::builtinOperators(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        ApplyOperator work(ops[i]);
+        measure(string("operator/") + ops[i].name, work);
+    }
+}
+
+static void commands()
+{
+    Calculator calculator;
+    PerformCommands dupPop(calculator, "dup", "pop");
+    PerformCommands swaps(calculator, "swap", "swap");
+
+    calculator.Eval("1 2");
+    measure("command/dup+pop", dupPop);
+    measure("command/swap+swap", swaps);
+}
+
+// pushh copies the stack, so its cost depends on how deep the stack is.
+static void history()
+{
+    const size_t depths[] = { 1, 100, 10000, 1000000 };
+    string line = pushes(1000);
+
+    for(size_t i = 0; i < sizeof(depths) / sizeof(*depths); ++i)
+    {
+        Calculator calculator;
+        PerformCommands work(calculator, "pushh", "poph");
+
+        if(depths[i] < 1000)
+            calculator.Eval(pushes(depths[i]));
+        else
+            for(size_t j = 0; j < depths[i]; j += 1000)
+                calculator.Eval(line);
+
+        measure(numbered("history/pushh+poph/", depths[i]), work);
+    }
+}
+
+static void evaluation()
+{
+    Calculator calculator;
+    vector<string> lines;
+
+    lines.push_back("1 2 + 3 * 4 / pop");
+    Evaluate arithmetic(calculator, lines);
+    measure("eval/arithmetic", arithmetic);
+
+    calculator.Eval("3 a 4 b pop pop");
+    lines[0] = "a 2 * b + a b * - pop";
+    Evaluate variables(calculator, lines);
+    measure("eval/variables", variables);
+
+    // twice as many lines as the calculator caches, so each is compiled.
+    lines.clear();
+    for(size_t i = 0; i < 2 * MAX_PROGRAMS; ++i)
+        lines.push_back(numbered("1 2 + ", i) + " * pop");
+    Evaluate compile(calculator, lines);
+    measure("eval/compile", compile);
+}
+
+void RPN::Bench::calculator()
+{
+    operators();
+    commands();
+    history();
+    evaluation();
+}
+
+//! Performs a printing command n times, throwing its output away each time.
+struct PrintStack
+{
+    PerformCommands print;
+
+    PrintStack(Calculator& calculator, const char* name)
+        : print(calculator, name)
+    {
+    }
+
+    void operator()(unsigned long n)
+    {
+        for(unsigned long i = 0; i < n; ++i)
+        {
+            print(1);
+            Port::Output().clear();
+        }
+    }
+};
+
+// the memory port collects the output, so this times formatting the stack
+// rather than writing it to a terminal.
+void RPN::Bench::printing()
+{
+    Calculator calculator;
+    PrintStack ps(calculator, "ps");
+    PrintStack psd(calculator, "psd");
+
+    calculator.Eval(pushes(100));
+    measure("print/ps/100", ps);
+    measure("print/psd/100", psd);
+}
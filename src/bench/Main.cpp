@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Main.cpp - runs the benchmarks and reports them as JSON.              *
+ ******************************************************************************/
+
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+using namespace RPN;
+using namespace std;
+
+//! A benchmark's result.
+struct Result
+{
+    string        name;
+    double        ns;
+    unsigned long iterations;
+};
+
+static vector<Result> results;
+static string filter;
+
+double RPN::Bench::now()
+{
+    timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void RPN::Bench::record(const string& name, double ns,
+                        unsigned long iterations)
+{
+    Result result = { name, ns, iterations };
+
+    results.push_back(result);
+    fprintf(stderr, "%-32s %12.1f ns\n", name.c_str(), ns);
+}
+
+bool RPN::Bench::selected(const string& name)
+{
+    return name.find(filter) != string::npos;
+}
+
+//! Reads the results in a file written by a previous run. Only the format
+//! written below is understood: one result per line.
+static bool readBaseline(const char* path, map<string, double>& baseline)
+{
+    FILE* file = fopen(path, "r");
+    char line[512], name[256];
+    double ns;
+
+    if(!file)
+        return false;
+
+    while(fgets(line, sizeof(line), file))
+        if(sscanf(line, " {\"name\": \"%255[^\"]\", \"ns\": %lf", name,
+                  &ns) == 2)
+            baseline[name] = ns;
+
+    fclose(file);
+    return true;
+}
+
+//! Writes the results as JSON. With a baseline, each result also has the
+//! baseline's time and the change from it in percent.
+static void writeResults(FILE* file, const map<string, double>& baseline)
+{
+    map<string, double>::const_iterator found;
+
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+
+        fprintf(file, "    {\"name\": \"%s\", \"ns\": %.3f, "
+                "\"iterations\": %lu", result.name.c_str(), result.ns,
+                result.iterations);
+        found = baseline.find(result.name);
+        if(found != baseline.end())
+            fprintf(file, ", \"baseline\": %.3f, \"change\": %.1f",
+                    found->second,
+                    (result.ns / found->second - 1) * 100);
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+//! Prints the benchmarks that got slower than the baseline by more than
+//! threshold percent, returning their number.
+static size_t compare(const map<string, double>& baseline, double threshold)
+{
+    map<string, double>::const_iterator found;
+    size_t regressions = 0;
+    double change;
+
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        found = baseline.find(results[i].name);
+        if(found == baseline.end())
+            continue;
+
+        change = (results[i].ns / found->second - 1) * 100;
+        if(change > threshold)
+        {
+            fprintf(stderr, "regressed: %-32s %10.1f ns -> %10.1f ns "
+                    "(%+.1f%%)\n", results[i].name.c_str(), found->second,
+                    results[i].ns, change);
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: rpn-bench [--filter TEXT] [--output FILE]\n"
+            "                 [--baseline FILE [--threshold PERCENT]]\n"
+            "Runs the benchmarks whose names contain TEXT and writes their\n"
+            "nanoseconds per iteration as JSON to FILE, or stdout. With a\n"
+            "baseline from an earlier run, exits with 1 if any benchmark\n"
+            "got more than PERCENT (10) slower.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* output = NULL;
+    const char* baselinePath = NULL;
+    double threshold = 10;
+    map<string, double> baseline;
+    FILE* file = stdout;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+            filter = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "--output") == 0)
+            output = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "--baseline") == 0)
+            baselinePath = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "--threshold") == 0)
+            threshold = atof(argv[++i]);
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if(baselinePath && !readBaseline(baselinePath, baseline))
+    {
+        fprintf(stderr, "rpn-bench: couldn't read %s\n", baselinePath);
+        return 2;
+    }
+
+    Bench::numbers();
+    Bench::calculator();
+    Bench::printing();
+
+    if(output && !(file = fopen(output, "w")))
+    {
+        fprintf(stderr, "rpn-bench: couldn't write %s\n", output);
+        return 2;
+    }
+    writeResults(file, baseline);
+    if(file != stdout)
+        fclose(file);
+
+    return baselinePath && compare(baseline, threshold) ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Numbers.cpp - benchmarks tokenizing and parsing numeric literals.     *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Bench.h"
+#include <string>
+#include <vector>
+using namespace RPN;
+using namespace RPN::Bench;
+using namespace std;
+
+//! Splits a line into tokens.
+struct Tokenize
+{
+    const string& line;
+    size_t        tokens;
+
+    Tokenize(const string& line) : line(line), tokens(0) {}
+
+    void operator()(unsigned long n)
+    {
+        Token tok;
+
+        for(unsigned long i = 0; i < n; ++i)
+        {
+            Lexer lexer(line);
+            while(lexer.Next(tok))
+                ++tokens;
+        }
+    }
+};
+
+//! Parses tokens, one per iteration.
+struct Parse
+{
+    const vector<string>& tokens;
+    Value                 sink;
+
+    Parse(const vector<string>& tokens) : tokens(tokens), sink(0) {}
+
+    void operator()(unsigned long n)
+    {
+        Value val;
+
+        for(unsigned long i = 0; i < n; ++i)
+        {
+            const string& tok = tokens[i % tokens.size()];
+            if(parseNumber(tok.data(), tok.data() + tok.size(), val))
+                sink += val;
+        }
+    }
+};
+
+static void parse(const char *name, const char **tokens, size_t n)
+{
+    vector<string> v(tokens, tokens + n);
+    Parse work(v);
+
+    measure(string("parse/") + name, work);
+}
+
+void RPN::Bench::numbers()
+{
+    const char *integers[] = { "1", "42", "1000", "65536", "123456789" };
+    const char *decimals[] = { "3.14159", "0.5", "2.718281828", "-17.25" };
+    const char *scientific[] = { "1e10", "6.02e23", "1.5e-7", "-2.5E+3" };
+    const char *words[] = { "+", "dup", "swap", "PI", "ps", "x1", "**" };
+    string line = "1 2 + 3.5 * KiB / dup 6.02e23 swap - ps";
+    Tokenize tokenize(line);
+
+    measure("lex/line", tokenize);
+    parse("integers", integers, sizeof(integers) / sizeof(*integers));
+    parse("decimals", decimals, sizeof(decimals) / sizeof(*decimals));
+    parse("scientific", scientific, sizeof(scientific) / sizeof(*scientific));
+    parse("non-numbers", words, sizeof(words) / sizeof(*words));
+}
@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Replay.cpp - replays a recorded session to measure throughput.        *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+using namespace RPN;
+using namespace std;
+
+//! How many timed runs there are unless another number is given.
+static const unsigned RUNS = 10;
+
+//! How many untimed runs come first unless another number is given.
+static const unsigned WARMUP = 2;
+
+//! What a replay of a transcript did.
+struct Run
+{
+    double        ns;
+    unsigned long allocations;
+    string        state;
+
+    Run() : ns(0), allocations(0), state() {}
+};
+
+//! Returns a monotonic time in nanoseconds.
+static double now()
+{
+    timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//! Reads a whole file into a string, returning false if it can't.
+static bool readFile(const char* path, string& contents)
+{
+    FILE* file = fopen(path, "rb");
+    char buffer[1 << 16];
+    size_t n;
+
+    if(!file)
+        return false;
+
+    while((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.append(buffer, n);
+
+    fclose(file);
+    return true;
+}
+
+//! Counts the lines of a transcript and the tokens on them.
+static void countTranscript(const string& transcript, unsigned long& lines,
+                            unsigned long& tokens)
+{
+    string line;
+    Token token;
+    size_t begin = 0, end;
+
+    lines = tokens = 0;
+    while(begin < transcript.size())
+    {
+        end = transcript.find('\n', begin);
+        if(end == string::npos)
+            end = transcript.size();
+        line.assign(transcript, begin, end - begin);
+        begin = end + 1;
+
+        Lexer lexer(line);
+        while(lexer.Next(token))
+            ++tokens;
+        ++lines;
+    }
+}
+
+//! Replays a transcript against a new calculator, the way the console's
+//! main loop would, and keeps the stack and variables it ended with. Only
+//! evaluating the lines is timed.
+static Run replay(const string& transcript)
+{
+    Calculator calculator;
+    Run run;
+    unsigned long allocations = allocationCount();
+    double start;
+
+    Port::Load(transcript);
+    Port::Output().clear();
+
+    start = now();
+    while(calculator.IsRunning() && Port::CanRun())
+    {
+        calculator.Eval(Port::GetLine());
+        Port::Output().clear();
+    }
+    run.ns = now() - start;
+    run.allocations = allocationCount() - allocations;
+
+    calculator.Eval("ps pv");
+    run.state.swap(Port::Output());
+    return run;
+}
+
+//! Returns a 64-bit FNV-1a hash of a string.
+static unsigned long long checksum(const string& s)
+{
+    unsigned long long h = 14695981039346656037ULL;
+
+    for(size_t i = 0; i < s.size(); ++i)
+        h = (h ^ (unsigned char)s[i]) * 1099511628211ULL;
+
+    return h;
+}
+
+//! Returns the most memory the process has had resident, in kilobytes.
+static long peakResident()
+{
+    rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: rpn-replay [--runs N] [--warmup N] [--checksum HEX]\n"
+            "                  [--json] TRANSCRIPT\n"
+            "Evaluates the lines of TRANSCRIPT on a new calculator N (10)\n"
+            "times, after N (2) untimed runs, and reports the median lines\n"
+            "and tokens per second, the allocations per run and the peak\n"
+            "resident memory. The checksum is of the stack and variables\n"
+            "left at the end; given one to expect, exits with 1 if they\n"
+            "differ from it.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = NULL;
+    const char* expected = NULL;
+    unsigned runs = RUNS, warmup = WARMUP;
+    bool json = false;
+    string transcript;
+    vector<double> times;
+    unsigned long lines, tokens;
+    unsigned long long sum;
+    double median, best;
+    Run run;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(i + 1 < argc && strcmp(argv[i], "--runs") == 0)
+            runs = atoi(argv[++i]);
+        else if(i + 1 < argc && strcmp(argv[i], "--warmup") == 0)
+            warmup = atoi(argv[++i]);
+        else if(i + 1 < argc && strcmp(argv[i], "--checksum") == 0)
+            expected = argv[++i];
+        else if(strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if(!path && argv[i][0] != '-')
+            path = argv[i];
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if(!path || !runs)
+    {
+        usage();
+        return 2;
+    }
+
+    if(!readFile(path, transcript))
+    {
+        fprintf(stderr, "rpn-replay: couldn't read %s\n", path);
+        return 2;
+    }
+    countTranscript(transcript, lines, tokens);
+
+    for(unsigned i = 0; i < warmup; ++i)
+        replay(transcript);
+    for(unsigned i = 0; i < runs; ++i)
+    {
+        run = replay(transcript);
+        times.push_back(run.ns);
+    }
+
+    // every run starts afresh, so the last one's allocations and state are
+    // the same as any other's.
+    sort(times.begin(), times.end());
+    median = times[times.size() / 2];
+    best = times[0];
+    sum = checksum(run.state);
+
+    if(json)
+        printf("{\"transcript\": \"%s\", \"lines\": %lu, \"tokens\": %lu, "
+               "\"runs\": %u, \"lines_per_second\": %.0f, "
+               "\"tokens_per_second\": %.0f, \"best_lines_per_second\": "
+               "%.0f, \"allocations\": %lu, \"peak_rss_kb\": %ld, "
+               "\"checksum\": \"%016llx\"}\n", path, lines, tokens, runs,
+               lines / median * 1e9, tokens / median * 1e9,
+               lines / best * 1e9, run.allocations, peakResident(), sum);
+    else
+        printf("%s: %lu lines, %lu tokens, %u runs\n"
+               "lines/s:     %.0f (best %.0f)\n"
+               "tokens/s:    %.0f (best %.0f)\n"
+               "allocations: %lu per run\n"
+               "peak RSS:    %ld KB\n"
+               "checksum:    %016llx\n", path, lines, tokens, runs,
+               lines / median * 1e9, lines / best * 1e9,
+               tokens / median * 1e9, tokens / best * 1e9,
+               run.allocations, peakResident(), sum);
+
+    if(expected && strtoull(expected, NULL, 16) != sum)
+    {
+        fprintf(stderr, "rpn-replay: checksum %016llx, expected %s\n", sum,
+                expected);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * bench/Startup.cpp - benchmarks starting rpn for a single -e.                *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+//! How many times rpn is started unless another number is given.
+static const int RUNS = 1000;
+
+//! Returns the time in microseconds.
+static double now()
+{
+    timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//! Starts rpn -e program, returning the microseconds from just before fork
+//! until its result could be read, or a negative number if it failed.
+static double startOnce(const char* rpn, const char* program)
+{
+    int fds[2];
+    char c;
+    double start, ret;
+    pid_t pid;
+    int status;
+
+    if(pipe(fds) != 0)
+        return -1;
+
+    start = now();
+    pid = fork();
+    if(pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execl(rpn, rpn, "-e", program, (char*)NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+
+    // the result is the first thing written.
+    ret = read(fds[0], &c, 1) == 1 ? now() - start : -1;
+    while(read(fds[0], &c, 1) == 1)
+        ;
+    close(fds[0]);
+
+    if(pid < 0 || waitpid(pid, &status, 0) != pid || status != 0)
+        return -1;
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* rpn = argc > 1 ? argv[1] : "bin/console/rpn";
+    int runs = argc > 2 ? atoi(argv[2]) : RUNS;
+    const char* program = argc > 3 ? argv[3] : "1 2 +";
+    vector<double> times;
+    double total = 0, time;
+
+    // the first few runs fault the binary and libraries into the page cache.
+    for(int i = 0; i < 10; ++i)
+        startOnce(rpn, program);
+
+    for(int i = 0; i < runs; ++i)
+    {
+        time = startOnce(rpn, program);
+        if(time < 0)
+        {
+            fprintf(stderr, "rpn-startup: couldn't run %s\n", rpn);
+            return 1;
+        }
+        times.push_back(time);
+        total += time;
+    }
+
+    if(times.empty())
+        return 0;
+    sort(times.begin(), times.end());
+    printf("%s -e '%s', %d runs, from fork to the first result:\n", rpn,
+           program, runs);
+    printf("    min %8.1f us  median %8.1f us  p90 %8.1f us  mean %8.1f us\n",
+           times[0], times[times.size() / 2], times[times.size() * 9 / 10],
+           total / times.size());
+
+    return 0;
+}
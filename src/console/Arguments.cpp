@@ -29,24 +29,126 @@
  ******************************************************************************/
 
 #include "../rpn.h"
+#include <cctype>
+#include <cstdlib>
+#include <thread>
 using namespace RPN;
 using namespace std;
 
-static void argumentEvaluate(vector<string>& args, Calculator& calculator)
+template <class T>
+static bool argumentEvaluate(vector<string>& args,
+                             BasicCalculator<T>& calculator)
 {
     calculator.Eval(args[0]);
     calculator.Display();
     Print('\n');
+    return true;
 }
 
-static void argumentHelp(vector<string>&, Calculator& calculator)
+template <class T>
+static bool argumentBatch(vector<string>&, BasicCalculator<T>& calculator)
+{
+    runBatch(calculator, stdin);
+    return true;
+}
+
+//! How many jobs -j runs at most for each core. Any more would only wait.
+static const unsigned JOBS_PER_CORE = 4;
+
+// with one job there's nothing to run alongside, so the lines are evaluated
+// in turn on one calculator, just as --batch does.
+template <class T>
+static bool argumentJobs(vector<string>& args, BasicCalculator<T>& calculator)
+{
+    const char* s = args[0].c_str();
+    unsigned cores = thread::hardware_concurrency();
+    unsigned long jobs = 0;
+    char* end = NULL;
+
+    // strtoul() would take a negative number and wrap it, so only digits do.
+    if(isdigit((unsigned char)*s))
+        jobs = strtoul(s, &end, 10);
+    if(!jobs || *end)
+    {
+        fprintf(stderr, "rpn: -j needs a positive number of jobs, not %s\n",
+                s);
+        return false;
+    }
+
+    if(jobs > (cores ? cores : 1) * JOBS_PER_CORE)
+        jobs = (cores ? cores : 1) * JOBS_PER_CORE;
+
+    if(jobs > 1)
+        runParallel<T>(jobs, stdin);
+    else
+        runBatch(calculator, stdin);
+    return true;
+}
+
+template <class T>
+static bool argumentEmitCpp(vector<string>& args, BasicCalculator<T>&)
+{
+    Print(exportCpp<T>(args[0]));
+    return true;
+}
+
+template <class T>
+static bool argumentEmitSharedObject(vector<string>& args,
+                                     BasicCalculator<T>&)
+{
+    if(exportSharedObject<T>(args[0], args[1]))
+        return true;
+
+    fprintf(stderr, "rpn: couldn't compile %s\n", args[1].c_str());
+    return false;
+}
+
+#ifdef RPN_STATS
+//! Whether to write the statistics as JSON when rpn exits.
+static bool statisticsJson = false;
+#endif
+
+template <class T>
+static bool argumentStatisticsJson(vector<string>&, BasicCalculator<T>&)
+{
+#ifdef RPN_STATS
+    statisticsJson = true;
+#else
+    fprintf(stderr, "rpn: --stats-json needs a build with RPN_STATS\n");
+#endif
+    return true;
+}
+
+//! Whether to write the latency report as JSON.
+static bool latencyJson = false;
+
+template <class T>
+static bool argumentLatencyReport(vector<string>&, BasicCalculator<T>&)
+{
+    enableLatencies();
+    return true;
+}
+
+template <class T>
+static bool argumentLatencyJson(vector<string>&, BasicCalculator<T>&)
+{
+    enableLatencies();
+    latencyJson = true;
+    return true;
+}
+
+template <class T>
+static bool argumentHelp(vector<string>&, BasicCalculator<T>& calculator)
 {
     calculator.Eval("help");
+    return true;
 }
 
-static void argumentVersion(vector<string>&, Calculator& calculator)
+template <class T>
+static bool argumentVersion(vector<string>&, BasicCalculator<T>& calculator)
 {
     calculator.Eval("ver");
+    return true;
 }
 
 //! Converts command-line arguments into a vector of strings.
@@ -60,63 +162,151 @@ vector<string> RPN::vectorize(char **argv, int argc)
     return ret;
 }
 
+//! Returns the type chosen by a --type= argument, or DefaultType if there
+//! isn't one. If the type isn't known, says so and returns UnknownType.
+ValueType RPN::findValueType(const vector<string>& args)
+{
+    static const string prefix = "--type=";
+    ValueType type = DefaultType;
+
+    for(vector<string>::const_iterator it = args.begin();
+        it != args.end(); it++)
+    {
+        if(it->compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        string name = it->substr(prefix.size());
+        if(name == "float")
+            type = FloatType;
+        else if(name == "double")
+            type = DoubleType;
+        else if(name == "long-double")
+            type = LongDoubleType;
+        else
+        {
+            fprintf(stderr, "rpn: unknown type %s (use float, double or "
+                    "long-double)\n", name.c_str());
+            return UnknownType;
+        }
+    }
+
+    return type;
+}
+
 //! Processes a vector of arguments and performs valid ones as found.
-bool RPN::processArguments(const vector<string>& args,
-                           const Arguments& arguments,
-                           Calculator& calculator)
+template <class T>
+ArgumentsOutcome RPN::processArguments(const vector<string>& args,
+                                       BasicCalculator<T>& calculator)
 {
-    bool continueProgram = true;
-    bool performed = false;
+    size_t count;
+    const BasicArgument<T>* arguments = consoleArguments<T>(count);
 
     // iterate through the arguments
     for(vector<string>::const_iterator it = args.begin();
-        it != args.end() && continueProgram; it++)
+        it != args.end(); it++)
     {
-        Arguments::const_iterator found = arguments.find(*it);
+        const BasicArgument<T>* found = findBuiltin(arguments, count, *it);
+        unsigned n;
+
+        if(!found)
+            continue;
 
-        // if an argument was found in the map,
-        if(found != arguments.end())
+        // an argument that's missing its own arguments is an error, rather
+        // than being skipped or reading past the end.
+        n = found->NumArgs();
+        if(args.end() - it <= (ptrdiff_t)n)
         {
-            // if the argument requires arguments and there are enough,
-            if(found->second.NumArgs() &&
-               it + found->second.NumArgs() != args.end())
-            {
-                // create a sub-vector of the arguments,
-                vector<string> argument_args(
-                    it + 1, it + found->second.NumArgs() + 1);
-                // and perform the argument.
-                found->second.Perform(argument_args, calculator);
-                performed = true;
-                // then skip the argument's arguments.
-                it += found->second.NumArgs();
-            }
-            // if the argument requires no arguments,
-            else if(found->second.NumArgs() == 0)
-            {
-                // perform it with an empty arguments vector.
-                vector<string> argument_args;
-                found->second.Perform(argument_args, calculator);
-                performed = true;
-            }
-
-            // ask the argument whether to continue the program.
-            if(performed)
-                continueProgram = found->second.ContinueProgram();
+            fprintf(stderr, "rpn: %s needs %u argument%s\n", found->name, n,
+                    n == 1 ? "" : "s");
+            return ArgumentError;
         }
 
-        // the next argument is not yet performed.
-        performed = false;
+        // perform the argument with its own arguments, then skip them.
+        vector<string> argument_args(it + 1, it + n + 1);
+        if(!found->Perform(argument_args, calculator))
+            return ArgumentError;
+        it += n;
+
+        // ask the argument whether to continue the program.
+        if(!found->ContinueProgram())
+            return ExitProgram;
     }
 
-    return continueProgram;
+    return RunCalculator;
 }
 
-//! Creates a default arguments map.
-void RPN::setupArguments(Arguments& arguments)
+template <class T>
+const BasicArgument<T>* RPN::consoleArguments(size_t& count)
 {
-    arguments["-h"]        = Argument(0, true,  argumentHelp);
-    arguments["-e"]        = Argument(1, false, argumentEvaluate);
-    arguments["-v"]        = Argument(0, false, argumentVersion);
-    arguments["--help"]    = Argument(0, true,  argumentHelp);
-    arguments["--version"] = Argument(0, false, argumentVersion);
+    // must be sorted by name.
+    static constexpr BasicArgument<T> arguments[] =
+    {
+        { "--batch",          0, false, argumentBatch<T>            },
+        { "--emit-cpp",       1, false, argumentEmitCpp<T>          },
+        { "--emit-so",        2, false, argumentEmitSharedObject<T> },
+        { "--help",           0, true,  argumentHelp<T>             },
+        { "--latency-json",   0, true,  argumentLatencyJson<T>      },
+        { "--latency-report", 0, true,  argumentLatencyReport<T>    },
+        { "--stats-json",     0, true,  argumentStatisticsJson<T>   },
+        { "--version",        0, false, argumentVersion<T>          },
+        { "-e",               1, false, argumentEvaluate<T>         },
+        { "-h",               0, true,  argumentHelp<T>             },
+        { "-j",               1, false, argumentJobs<T>             },
+        { "-v",               0, false, argumentVersion<T>          }
+    };
+    static_assert(sortedByName(arguments), "arguments must be sorted by name");
+
+    count = sizeof(arguments) / sizeof(*arguments);
+    return arguments;
+}
+
+//! Writes the latency report to stderr if --latency-report asked for it,
+//! and the statistics as JSON if --stats-json asked for them.
+template <class T>
+void RPN::finishArguments(const BasicCalculator<T>& calculator)
+{
+    if(latencies())
+        printLatencies(*latencies(), stderr, latencyJson);
+
+#ifdef RPN_STATS
+    const vector<Statistic>& rows = calculator.GetStatistics().Rows();
+    const char* separator = "";
+
+    if(!statisticsJson)
+        return;
+
+    fprintf(stderr, "{\n  \"unit\": \"%s\",\n  \"statistics\": [\n",
+            Statistics::Unit());
+    for(size_t i = 0; i < rows.size(); ++i)
+    {
+        if(!rows[i].count)
+            continue;
+
+        fprintf(stderr, "%s    {\"kind\": \"%s\", \"name\": \"", separator,
+                rows[i].kind);
+        for(size_t j = 0; j < rows[i].name.size(); ++j)
+        {
+            char c = rows[i].name[j];
+            if(c == '"' || c == '\\')
+                fputc('\\', stderr);
+            if((unsigned char)c < ' ')
+                fprintf(stderr, "\\u%04x", c);
+            else
+                fputc(c, stderr);
+        }
+        fprintf(stderr, "\", \"count\": %lu, \"time\": %llu}",
+                rows[i].count, rows[i].time);
+        separator = ",\n";
+    }
+    fprintf(stderr, "\n  ]\n}\n");
+#else
+    (void)calculator;
+#endif
 }
+
+#define INSTANTIATE(T) \
+    template ArgumentsOutcome RPN::processArguments( \
+        const vector<string>&, BasicCalculator<T>&); \
+    template const BasicArgument<T>* RPN::consoleArguments<T>(size_t&); \
+    template void RPN::finishArguments(const BasicCalculator<T>&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -31,30 +31,27 @@
 #ifndef RPN_CONSOLE_ARGUMENT
 #define RPN_CONSOLE_ARGUMENT
 
-#include <map>
 #include <string>
 #include <vector>
 #include "../typedefs.h"
 
 namespace RPN
 {
-    class Argument
+    //! A command-line argument. The arguments are a plain array sorted by
+    //! name, like the calculator's built-ins, so that startup doesn't have
+    //! to build a map of them.
+    template <class T>
+    struct BasicArgument
     {
-        unsigned nargs;
-        bool     continueProgram;
-        void     (*f)(std::vector<std::string>&, Calculator&);
+        //! Performs an argument, returning false if it failed, having said
+        //! why.
+        typedef bool (*Function)(std::vector<std::string>&,
+                                 BasicCalculator<T>&);
 
-    public:
-        Argument()
-            : nargs(0), continueProgram(true), f(NULL)
-        {
-        }
-
-        Argument(unsigned nargs, bool continueProgram,
-                 void (*f)(std::vector<std::string>&, Calculator&))
-            : nargs(nargs), continueProgram(continueProgram), f(f)
-        {
-        }
+        const char* name;
+        unsigned    nargs;
+        bool        continueProgram;
+        Function    f;
 
         bool ContinueProgram() const
         {
@@ -66,19 +63,47 @@ namespace RPN
             return nargs;
         }
 
-        void Perform(std::vector<std::string>& args, Calculator& calc) const
+        bool Perform(std::vector<std::string>& args,
+                     BasicCalculator<T>& calc) const
         {
-            if(f) f(args, calc);
+            return f ? f(args, calc) : true;
         }
     };
 
-    typedef std::map<std::string, Argument> Arguments;
+    typedef BasicArgument<Value> Argument;
+
+    //! The types a calculator can be chosen to operate on with --type=.
+    enum ValueType
+    {
+        DefaultType,
+        FloatType,
+        DoubleType,
+        LongDoubleType,
+        UnknownType
+    };
+
+    //! What the program does once its arguments have been processed.
+    enum ArgumentsOutcome
+    {
+        //! Runs the calculator on the lines typed in.
+        RunCalculator,
+        //! Exits, since an argument has done all that was asked.
+        ExitProgram,
+        //! Exits with an error, which has already been reported.
+        ArgumentError
+    };
 
     std::vector<std::string> vectorize(char **argv, int argc);
-    bool processArguments(const std::vector<std::string>& args,
-                          const Arguments& arguments,
-                          Calculator& calculator);
-    void setupArguments(Arguments& arguments);
+    ValueType findValueType(const std::vector<std::string>& args);
+    template <class T>
+    ArgumentsOutcome processArguments(const std::vector<std::string>& args,
+                                      BasicCalculator<T>& calculator);
+    //! Does what the arguments asked for when the calculator is done.
+    template <class T>
+    void finishArguments(const BasicCalculator<T>& calculator);
+    //! Returns the arguments, sorted by name, and their number.
+    template <class T>
+    const BasicArgument<T>* consoleArguments(size_t& count);
 }
 
 #endif
@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Batch.cpp - non-interactive batch mode for the console port.                *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Batch.h"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+using namespace RPN;
+using namespace std;
+
+//! The size of the input buffer.
+static const size_t BATCH_BUFFER_SIZE = 1 << 20;
+
+//! How many lines are handed to a worker at once in parallel mode.
+static const size_t CHUNK_LINES = 4096;
+
+//! How many chunks per worker may be read ahead of the output.
+static const size_t CHUNKS_PER_JOB = 4;
+
+
+LineReader::LineReader(FILE* file)
+    : file(file), buffer(BATCH_BUFFER_SIZE), begin(0), end(0), eof(false)
+{
+}
+
+void LineReader::Fill()
+{
+    size_t n;
+
+    // move what's left to the front, growing the buffer if a single line
+    // doesn't fit in it.
+    memmove(&buffer[0], &buffer[begin], end - begin);
+    end -= begin;
+    begin = 0;
+    if(end == buffer.size())
+        buffer.resize(buffer.size() * 2);
+
+    n = fread(&buffer[end], 1, buffer.size() - end, file);
+    end += n;
+    if(n == 0)
+        eof = true;
+}
+
+bool LineReader::Next(string& line)
+{
+    const char* start;
+    const char* newline;
+
+    for(;;)
+    {
+        start = &buffer[0] + begin;
+        newline = (const char*)memchr(start, '\n', end - begin);
+
+        if(newline)
+        {
+            line.assign(start, newline - start);
+            begin += newline - start + 1;
+            return true;
+        }
+
+        if(eof)
+        {
+            if(begin == end)
+                return false;
+            line.assign(start, end - begin);
+            begin = end;
+            return true;
+        }
+
+        Fill();
+    }
+}
+
+template <class T>
+void RPN::runBatch(BasicCalculator<T>& calculator, FILE* in)
+{
+    LineReader reader(in);
+    OutputBuffer& output = Port::Output();
+    LatencyHistogram* histogram = latencies();
+    string line;
+
+    while(calculator.IsRunning() && reader.Next(line))
+    {
+        timedEval(calculator, line, histogram);
+        output.Write(calculator.TopmostItem());
+        output.Write("\n", 1);
+    }
+}
+
+#ifndef DOXYGEN_SKIP
+
+//! A run of input lines, and later their results.
+struct Chunk
+{
+    string         input;
+    vector<size_t> ends;
+    string         output;
+    //! Whether a line stopped the calculator, which ends the input there.
+    bool           stopped;
+    bool           done;
+
+    Chunk() : input(), ends(), output(), stopped(false), done(false) {}
+};
+
+//! The state shared between the reader, the workers and the writer.
+struct Pipeline
+{
+    mutex              lock;
+    condition_variable changed;
+    deque<Chunk*>      pending;
+    deque<Chunk*>      inFlight;
+    bool               finished;
+    //! Whether a chunk that stopped has been written. Only the writer uses
+    //! it.
+    bool               stopped;
+
+    Pipeline()
+        : lock(), changed(), pending(), inFlight(), finished(false),
+          stopped(false)
+    {
+    }
+};
+
+//! Evaluates every line of a chunk on a reset calculator, so that no line
+//! depends on another, counting how long each took in histogram if there is
+//! one. Output is the worker's buffer for stdout, which captures the results
+//! and anything the lines print into the chunk. A line that stops the
+//! calculator is the last, as in --batch.
+template <class T>
+static void evaluateChunk(BasicCalculator<T>& calculator, Chunk& chunk,
+                          OutputBuffer& output, LatencyHistogram* histogram)
+{
+    string line;
+    size_t begin = 0;
+
+    output.Capture(&chunk.output);
+    for(size_t i = 0; i < chunk.ends.size(); ++i)
+    {
+        line.assign(chunk.input, begin, chunk.ends[i] - begin);
+        begin = chunk.ends[i] + 1;
+
+        calculator.Reset();
+        timedEval(calculator, line, histogram);
+        output.Write(calculator.TopmostItem());
+        output.Write("\n", 1);
+
+        if(!calculator.IsRunning())
+        {
+            chunk.stopped = true;
+            break;
+        }
+    }
+    output.Capture(NULL);
+}
+
+//! Takes chunks off the pending queue until there are no more.
+template <class T>
+static void worker(Pipeline& pipeline)
+{
+    BasicCalculator<T> calculator;
+    OutputBuffer& output = Port::Output();
+    LatencyHistogram* shared = latencies();
+    LatencyHistogram histogram;
+    Chunk* chunk;
+
+    for(;;)
+    {
+        {
+            unique_lock<mutex> guard(pipeline.lock);
+            while(pipeline.pending.empty() && !pipeline.finished)
+                pipeline.changed.wait(guard);
+            if(pipeline.pending.empty())
+            {
+                // each worker counts on its own, and adds them up at the end.
+                if(shared)
+                    shared->Add(histogram);
+                return;
+            }
+            chunk = pipeline.pending.front();
+            pipeline.pending.pop_front();
+        }
+
+        evaluateChunk(calculator, *chunk, output, shared ? &histogram : 0);
+
+        {
+            lock_guard<mutex> guard(pipeline.lock);
+            chunk->done = true;
+        }
+        pipeline.changed.notify_all();
+    }
+}
+
+//! Writes out finished chunks in input order. While limit or more chunks are
+//! in flight, waits for the oldest one to finish. Chunks after one that
+//! stopped are thrown away.
+static void writeFinished(Pipeline& pipeline, OutputBuffer& output,
+                          size_t limit)
+{
+    Chunk* chunk;
+
+    for(;;)
+    {
+        {
+            unique_lock<mutex> guard(pipeline.lock);
+            while(!pipeline.inFlight.empty() &&
+                  !pipeline.inFlight.front()->done &&
+                  pipeline.inFlight.size() >= limit)
+                pipeline.changed.wait(guard);
+            if(pipeline.inFlight.empty() || !pipeline.inFlight.front()->done)
+                return;
+            chunk = pipeline.inFlight.front();
+            pipeline.inFlight.pop_front();
+        }
+
+        if(!pipeline.stopped)
+            output.Write(chunk->output.data(), chunk->output.size());
+        pipeline.stopped = pipeline.stopped || chunk->stopped;
+        delete chunk;
+    }
+}
+
+#endif
+
+template <class T>
+void RPN::runParallel(unsigned jobs, FILE* in)
+{
+    LineReader reader(in);
+    OutputBuffer& output = Port::Output();
+    Pipeline pipeline;
+    vector<thread> workers;
+    string line;
+    Chunk* chunk;
+    bool more = true;
+
+    for(unsigned i = 0; i < jobs; ++i)
+        workers.push_back(thread(worker<T>, ref(pipeline)));
+
+    // a line that stops the calculator ends the input.
+    while(more && !pipeline.stopped)
+    {
+        chunk = new Chunk;
+        while(chunk->ends.size() < CHUNK_LINES && (more = reader.Next(line)))
+        {
+            chunk->input += line;
+            chunk->ends.push_back(chunk->input.size());
+            chunk->input += '\n';
+        }
+
+        // don't read too far ahead of the slowest chunk.
+        writeFinished(pipeline, output, jobs * CHUNKS_PER_JOB);
+
+        {
+            lock_guard<mutex> guard(pipeline.lock);
+            pipeline.pending.push_back(chunk);
+            pipeline.inFlight.push_back(chunk);
+        }
+        pipeline.changed.notify_all();
+    }
+
+    {
+        lock_guard<mutex> guard(pipeline.lock);
+        pipeline.finished = true;
+    }
+    pipeline.changed.notify_all();
+
+    for(size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+    writeFinished(pipeline, output, 0);
+}
+
+#define INSTANTIATE(T) \
+    template void RPN::runBatch(BasicCalculator<T>&, FILE*); \
+    template void RPN::runParallel<T>(unsigned, FILE*);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
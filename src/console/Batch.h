@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Batch.h - non-interactive batch mode for the console port.                  *
+ ******************************************************************************/
+
+#ifndef RPN_CONSOLE_BATCH_H
+#define RPN_CONSOLE_BATCH_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../typedefs.h"
+
+namespace RPN
+{
+    //! Reads a file in large blocks and hands it out a line at a time.
+    class LineReader
+    {
+        std::FILE*        file;
+        std::vector<char> buffer;
+        size_t            begin;
+        size_t            end;
+        bool              eof;
+
+        LineReader(const LineReader&);
+        LineReader& operator=(const LineReader&);
+
+        //! Reads more of the file, keeping the unread part of the buffer.
+        void Fill();
+
+    public:
+
+        explicit LineReader(std::FILE* file);
+
+        //! Stores the next line, without its newline, in line. Returns false
+        //! at the end of the file.
+        bool Next(std::string& line);
+    };
+
+    //! Evaluates each line of in and writes the resulting top of the stack to
+    //! stdout, one line of output per line of input. Anything a line prints
+    //! comes before its result.
+    template <class T>
+    void runBatch(BasicCalculator<T>& calculator, std::FILE* in);
+
+    //! Evaluates each line of in on its own, spread over a number of threads
+    //! that each have their own calculator. Every line starts afresh, with an
+    //! empty stack and only the predefined variables. The results, and
+    //! anything the lines print, are written to stdout in input order. As in
+    //! runBatch(), a line that stops the calculator ends the input.
+    template <class T>
+    void runParallel(unsigned jobs, std::FILE* in);
+}
+
+#endif
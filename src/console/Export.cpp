@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Export.cpp - exporting programs as C++ for the console port.                *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Export.h"
+#include <cstdio>
+#include <cstdlib>
+using namespace RPN;
+using namespace std;
+
+#ifdef _WIN32
+#define popen  _popen
+#define pclose _pclose
+#endif
+
+// where the generated code finds Operators.h. the Makefile points this at
+// the source directory.
+#ifndef RPN_SOURCE_DIR
+#define RPN_SOURCE_DIR "."
+#endif
+
+template <class T> static const char* typeName();
+template <> const char* typeName<float>()       { return "float"; }
+template <> const char* typeName<double>()      { return "double"; }
+template <> const char* typeName<long double>() { return "long double"; }
+
+template <class T> static const char* literalSuffix();
+template <> const char* literalSuffix<float>()       { return "f"; }
+template <> const char* literalSuffix<double>()      { return ""; }
+template <> const char* literalSuffix<long double>() { return "L"; }
+
+//! Returns a number as a C++ literal of type T that has exactly its value.
+template <class T>
+static string literal(T value)
+{
+    char s[NUMBER_SIZE];
+    string ret(s, formatShortest(s, value));
+
+    if(ret.find("nan") != string::npos)
+        return string("(") + typeName<T>() + ")NAN";
+    if(ret.find("inf") != string::npos)
+        return string(value < 0 ? "-" : "") + "(" + typeName<T>() +
+               ")INFINITY";
+
+    // a suffix needs a decimal point or an exponent before it.
+    if(ret.find_first_of(".e") == string::npos)
+        ret += ".0";
+    return ret + literalSuffix<T>();
+}
+
+//! Returns a number as a string, for naming temporaries.
+static string count(size_t n)
+{
+    char s[NUMBER_SIZE];
+    snprintf(s, sizeof(s), "%lu", (unsigned long)n);
+    return s;
+}
+
+//! Quotes a string for the shell.
+static string shellQuote(const string& s)
+{
+    string ret = "'";
+
+    for(size_t i = 0; i < s.size(); ++i)
+        if(s[i] == '\'')
+            ret += "'\\''";
+        else
+            ret += s[i];
+
+    return ret + "'";
+}
+
+template <class T>
+string RPN::exportCpp(const string& program)
+{
+    typedef BasicCalculator<T> Calculator;
+    size_t numCommands, numOperators, numVariables;
+    const typename Calculator::BuiltinCommand* commands;
+    const typename Calculator::BuiltinOperator* operators;
+    const typename Calculator::BuiltinVariable* variables;
+    const typename Calculator::BuiltinOperator* op;
+    const typename Calculator::BuiltinVariable* variable;
+    const string type = typeName<T>();
+    Lexer lexer(program);
+    Token tok;
+    vector<string> stack, names, stored;
+    string body, ret;
+    size_t temporaries = 0;
+
+    commands = Calculator::builtinCommands(numCommands);
+    operators = Calculator::builtinOperators(numOperators);
+    variables = Calculator::builtinVariables(numVariables);
+
+    while(lexer.Next(tok))
+    {
+        T value;
+        string name;
+        size_t i;
+
+        if(parseNumber(tok.begin, tok.begin + tok.length, value))
+        {
+            stack.push_back(literal(value));
+            continue;
+        }
+
+        name = tok.Str();
+
+        if(findBuiltin(commands, numCommands, name))
+            return "#error \"rpn: the command " + name +
+                   " can't be exported\"\n";
+
+        // an operator with enough operands becomes a call of its function.
+        op = findBuiltin(operators, numOperators, name);
+        if(op && stack.size() >= op->arity)
+        {
+            string call = string(op->function) + "(";
+
+            for(i = stack.size() - op->arity; i < stack.size(); ++i)
+                call += stack[i] + (i + 1 < stack.size() ? ", " : ")");
+            stack.resize(stack.size() - op->arity);
+
+            stack.push_back("t" + count(temporaries++));
+            body += "    const " + type + " " + stack.back() + " = " + call +
+                    ";\n";
+            continue;
+        }
+
+        // anything else is a variable. one that has been set pushes its
+        // value, as do the predefined ones, which start out set.
+        for(i = 0; i < names.size() && names[i] != name; ++i)
+            ;
+        if(i < names.size())
+        {
+            stack.push_back(stored[i]);
+            continue;
+        }
+
+        variable = findBuiltin(variables, numVariables, name);
+        if(variable)
+        {
+            stack.push_back(literal(variable->value));
+            continue;
+        }
+
+        // the first time, it's set to the top of the stack, or 0 if the stack
+        // is empty, and nothing is pushed. everything on the stack is a
+        // constant, so the variable can just name the same one.
+        names.push_back(name);
+        stored.push_back(stack.empty() ? literal(T(0)) : stack.back());
+    }
+
+    ret = "// Generated by rpn --emit-cpp. Build it with the rpn source\n"
+          "// directory on the include path.\n"
+          "#include \"Operators.h\"\n\n"
+          "extern \"C\" " + type + " rpn_program()\n"
+          "{\n    using namespace RPN::Operators;\n" + body +
+          "    return " + (stack.empty() ? "0" : stack.back()) + ";\n}\n";
+
+    return ret;
+}
+
+template <class T>
+bool RPN::exportSharedObject(const string& program, const string& path)
+{
+    const char* compiler = getenv("CXX");
+    string code = exportCpp<T>(program);
+    string command;
+    FILE* pipe;
+
+    command = string(compiler ? compiler : "c++") +
+              " -O2 -shared -fPIC -x c++ -I" + shellQuote(RPN_SOURCE_DIR) +
+              " -o " + shellQuote(path) + " -";
+
+    pipe = popen(command.c_str(), "w");
+    if(!pipe)
+        return false;
+
+    fwrite(code.data(), 1, code.size(), pipe);
+    return pclose(pipe) == 0;
+}
+
+#define INSTANTIATE(T) \
+    template string RPN::exportCpp<T>(const string&); \
+    template bool RPN::exportSharedObject<T>(const string&, const string&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Export.h - exporting programs as C++ for the console port.                  *
+ ******************************************************************************/
+
+#ifndef RPN_CONSOLE_EXPORT_H
+#define RPN_CONSOLE_EXPORT_H
+
+#include <string>
+#include "../typedefs.h"
+
+namespace RPN
+{
+    //! Translates a program into a C++ function named rpn_program, built
+    //! from the functions in Operators.h. It returns the top of the stack
+    //! that running the program on a new calculator leaves, so variables
+    //! are set and read as the calculator would. A program that can't be
+    //! translated, e.g. because it uses a command, gives a file that fails
+    //! to compile with an #error saying why.
+    template <class T>
+    std::string exportCpp(const std::string& program);
+
+    //! Compiles a program into a shared object at path with the C++ compiler
+    //! named by $CXX, or c++. Returns false if the compiler failed.
+    template <class T>
+    bool exportSharedObject(const std::string& program,
+                            const std::string& path);
+}
+
+#endif
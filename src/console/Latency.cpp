@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Latency.cpp - a histogram of how long lines take to evaluate.               *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include <ctime>
+using namespace RPN;
+using namespace std;
+
+//! The percentiles that are reported.
+static const double PERCENTILES[] = { 50, 90, 99, 99.9 };
+
+//! The names the percentiles are reported by.
+static const char* const PERCENTILE_NAMES[] = { "p50", "p90", "p99", "p99.9" };
+
+//! The histogram lines are counted in, once --latency-report asks for one.
+static LatencyHistogram* lineLatencies = 0;
+
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKETS), total(0), max(0)
+{
+}
+
+size_t LatencyHistogram::Bucket(unsigned long long time)
+{
+    unsigned bits = 0;
+    unsigned shift;
+
+    while(bits < 64 && time >> bits)
+        ++bits;
+
+    // times below SUB_BUCKETS are counted exactly; above that, only the top
+    // SUB_BITS bits of a time are kept, and the bits dropped pick the half
+    // of the buckets that are used.
+    shift = bits > SUB_BITS ? bits - SUB_BITS : 0;
+    return shift * (SUB_BUCKETS / 2) + size_t(time >> shift);
+}
+
+unsigned long long LatencyHistogram::Highest(size_t bucket)
+{
+    size_t shift;
+
+    if(bucket < SUB_BUCKETS)
+        return bucket;
+
+    shift = bucket / (SUB_BUCKETS / 2) - 1;
+    bucket -= shift * (SUB_BUCKETS / 2);
+    return ((unsigned long long)(bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(unsigned long long time)
+{
+    ++counts[Bucket(time)];
+    ++total;
+    if(time > max)
+        max = time;
+}
+
+void LatencyHistogram::Add(const LatencyHistogram& other)
+{
+    for(size_t i = 0; i < BUCKETS; ++i)
+        counts[i] += other.counts[i];
+    total += other.total;
+    if(other.max > max)
+        max = other.max;
+}
+
+unsigned long long LatencyHistogram::Percentile(double percent) const
+{
+    unsigned long long wanted = (unsigned long long)(percent / 100 * total);
+    unsigned long long seen = 0;
+
+    // the time at which at least wanted times have been seen.
+    if(wanted * 100 < percent * total)
+        ++wanted;
+    if(!wanted)
+        wanted = 1;
+
+    for(size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += counts[i];
+        if(seen >= wanted)
+            return Highest(i) < max ? Highest(i) : max;
+    }
+
+    return max;
+}
+
+unsigned long long RPN::latencyClock()
+{
+    timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void RPN::enableLatencies()
+{
+    if(!lineLatencies)
+        lineLatencies = new LatencyHistogram;
+}
+
+LatencyHistogram* RPN::latencies()
+{
+    return lineLatencies;
+}
+
+void RPN::printLatencies(const LatencyHistogram& histogram, FILE* file,
+                         bool json)
+{
+    const size_t count = sizeof(PERCENTILES) / sizeof(*PERCENTILES);
+
+    if(json)
+    {
+        fprintf(file, "{\"unit\": \"ns\", \"lines\": %llu",
+                histogram.Count());
+        for(size_t i = 0; i < count; ++i)
+            fprintf(file, ", \"%s\": %llu", PERCENTILE_NAMES[i],
+                    histogram.Percentile(PERCENTILES[i]));
+        fprintf(file, ", \"max\": %llu}\n", histogram.Max());
+        return;
+    }
+
+    fprintf(file, "lines: %llu\n", histogram.Count());
+    for(size_t i = 0; i < count; ++i)
+        fprintf(file, "%-6s %llu ns\n", PERCENTILE_NAMES[i],
+                histogram.Percentile(PERCENTILES[i]));
+    fprintf(file, "%-6s %llu ns\n", "max", histogram.Max());
+}
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Latency.h - a histogram of how long lines take to evaluate.                 *
+ ******************************************************************************/
+
+#ifndef RPN_CONSOLE_LATENCY_H
+#define RPN_CONSOLE_LATENCY_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../typedefs.h"
+
+namespace RPN
+{
+    //! A histogram of times in nanoseconds, laid out like an HDR histogram:
+    //! every power of two is split into the same number of linear buckets,
+    //! so each time is kept to within a fixed fraction of itself however
+    //! large it is, in a fixed amount of memory.
+    class LatencyHistogram
+    {
+        //! Each power of two is split into 2^SUB_BITS / 2 buckets, which
+        //! keeps times to within 1/64 of themselves.
+        static const unsigned SUB_BITS = 7;
+        static const size_t   SUB_BUCKETS = size_t(1) << SUB_BITS;
+        static const size_t   BUCKETS = (64 - SUB_BITS + 2) * SUB_BUCKETS / 2;
+
+        std::vector<unsigned long long> counts;
+        unsigned long long              total;
+        unsigned long long              max;
+
+        //! Returns the bucket a time falls in.
+        static size_t Bucket(unsigned long long time);
+        //! Returns the largest time that falls in a bucket.
+        static unsigned long long Highest(size_t bucket);
+
+    public:
+
+        LatencyHistogram();
+
+        //! Counts a time.
+        void Record(unsigned long long time);
+        //! Adds the counts of another histogram to this one.
+        void Add(const LatencyHistogram& other);
+        //! Returns how many times were counted.
+        unsigned long long Count() const { return total; }
+        //! Returns the largest time counted.
+        unsigned long long Max() const { return max; }
+        //! Returns the time that percent of the counted times are at most.
+        unsigned long long Percentile(double percent) const;
+    };
+
+    //! Returns the time of a monotonic clock in nanoseconds.
+    unsigned long long latencyClock();
+
+    //! Starts counting how long each line takes to evaluate.
+    void enableLatencies();
+    //! Returns the histogram lines are counted in, or 0 if they aren't.
+    LatencyHistogram* latencies();
+    //! Writes the percentiles of a histogram to a file, as text or as JSON.
+    void printLatencies(const LatencyHistogram& histogram, std::FILE* file,
+                        bool json);
+
+    //! Evaluates a line, counting how long it took in histogram if there is
+    //! one.
+    template <class T>
+    inline void timedEval(BasicCalculator<T>& calculator,
+                          const std::string& line,
+                          LatencyHistogram* histogram)
+    {
+        unsigned long long start;
+
+        if(!histogram)
+        {
+            calculator.Eval(line);
+            return;
+        }
+
+        start = latencyClock();
+        calculator.Eval(line);
+        histogram->Record(latencyClock() - start);
+    }
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Output.cpp - buffered output for the console port.                          *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include <cstring>
+using namespace RPN;
+using namespace std;
+
+OutputBuffer::OutputBuffer(FILE* file, size_t size)
+    : file(file), text(NULL), buffer(size), used(0)
+{
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    Flush();
+}
+
+void OutputBuffer::Write(const char* s, size_t n)
+{
+    if(used + n > buffer.size())
+    {
+        Flush();
+        if(n > buffer.size())
+        {
+            if(text)
+                text->append(s, n);
+            else
+                fwrite(s, 1, n, file);
+            return;
+        }
+    }
+
+    memcpy(&buffer[used], s, n);
+    used += n;
+}
+
+template <class T>
+void OutputBuffer::Write(const BasicItem<T>& item)
+{
+    char s[NUMBER_SIZE];
+    const T* values = item.Data();
+
+    if(!item.IsArray())
+    {
+        Write(s, formatNumber(s, *values));
+        return;
+    }
+
+    Write("{ ", 2);
+    for(size_t i = 0; i < item.Size(); ++i)
+    {
+        Write(s, formatNumber(s, values[i]));
+        Write(", ", 2);
+    }
+    Write("}", 1);
+}
+
+void OutputBuffer::Flush()
+{
+    if(text)
+    {
+        text->append(&buffer[0], used);
+        used = 0;
+        return;
+    }
+
+    if(used)
+        fwrite(&buffer[0], 1, used, file);
+    used = 0;
+    fflush(file);
+}
+
+void OutputBuffer::Capture(string* text)
+{
+    Flush();
+    this->text = text;
+}
+
+#define INSTANTIATE(T) \
+    template void OutputBuffer::Write(const BasicItem<T>&);
+RPN_FOR_EACH_TYPE(INSTANTIATE)
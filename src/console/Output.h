@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Output.h - buffered output for the console port.                            *
+ ******************************************************************************/
+
+#ifndef RPN_CONSOLE_OUTPUT_H
+#define RPN_CONSOLE_OUTPUT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../typedefs.h"
+
+namespace RPN
+{
+    //! Collects output in a large buffer and writes it only when it's full
+    //! or when flushed, to a file or to the end of a string.
+    class OutputBuffer
+    {
+        std::FILE*        file;
+        std::string*      text;
+        std::vector<char> buffer;
+        size_t            used;
+
+        OutputBuffer(const OutputBuffer&);
+        OutputBuffer& operator=(const OutputBuffer&);
+
+    public:
+
+        OutputBuffer(std::FILE* file, size_t size);
+        ~OutputBuffer();
+
+        //! Appends characters to the buffer.
+        void Write(const char* s, size_t n);
+        //! Appends an item, formatted the same way as Display() does.
+        template <class T>
+        void Write(const BasicItem<T>& item);
+        //! Writes out everything buffered so far.
+        void Flush();
+        //! Flushes, then sends everything written from now on to the end of
+        //! a string instead of the file, or back to the file if text is
+        //! NULL.
+        void Capture(std::string* text);
+    };
+}
+
+#endif
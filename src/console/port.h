@@ -36,14 +36,31 @@
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "Arguments.h"
+#include "Batch.h"
+#include "Export.h"
+#include "Latency.h"
+#include "Output.h"
 
 namespace RPN
 {
     class Port
     {
+        //! How much output is buffered before it's written to stdout.
+        static const size_t OUTPUT_SIZE = 1 << 16;
+
     public:
 
+        //! Returns the calling thread's buffer for stdout. Batch mode writes
+        //! its results through it as well, so that they stay in order with
+        //! what commands print.
+        static OutputBuffer& Output()
+        {
+            static thread_local OutputBuffer output(stdout, OUTPUT_SIZE);
+            return output;
+        }
+
         static bool CanRun()
         {
             return !!std::cin;
@@ -52,21 +69,41 @@ namespace RPN
         static std::string GetLine()
         {
             std::string ret;
+            Output().Flush();
             std::getline(std::cin, ret);
             return ret;
         }
 
         static void Post()
         {
+            Output().Flush();
         }
 
         static void Print(const char* str, ...)
         {
+            char buffer[256];
             va_list args;
+            int n;
 
             va_start(args, str);
-            vprintf(str, args);
+            n = vsnprintf(buffer, sizeof(buffer), str, args);
             va_end(args);
+
+            if(n < (int)sizeof(buffer))
+                Write(buffer, n);
+            else
+            {
+                std::vector<char> big(n + 1);
+                va_start(args, str);
+                vsnprintf(&big[0], big.size(), str, args);
+                va_end(args);
+                Write(&big[0], n);
+            }
+        }
+
+        static void Write(const char* str, size_t n)
+        {
+            Output().Write(str, n);
         }
 
         static void Setup()
@@ -41,6 +41,12 @@ namespace RPN
     const int VERSION_REVIS = 1;
     //! The build version number.
     const int VERSION_BUILD = 0;
+
+    //! How many compiled programs a calculator caches before starting over.
+    const unsigned MAX_PROGRAMS = 1024;
+    //! The largest whole power the optimizer computes by repeated squaring
+    //! rather than with pow().
+    const unsigned MAX_SQUARED_POWER = 64;
 }
 
 #endif
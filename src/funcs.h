@@ -33,7 +33,9 @@
 
 #include "typedefs.h"
 #include "HelpItem.h"
+#include <cstring>
 #include <sstream>
+#include <string>
 
 //! Calls an objects member function via pointer.
 #define CALL_MEMBER_FN(object,ptrToMember)  ((object).*(ptrToMember)) 
@@ -42,16 +44,131 @@ namespace RPN
 {
     //! Returns a C string of the version of the program.
     const char *getVersion();
-    //! Returns a default, empty History stack.
-    History defaultHistory();
-    //! Returns a map of the default operators.
-    Operators defaultOperators();
-    //! Returns a map of the default variables.
-    Variables defaultVariables();
-    //! Returns a list of the default help items.
-    HelpItems defaultHelpItems();
+    //! Returns the help items and their number.
+    const HelpItem* defaultHelpItems(size_t& count);
+    //! Parses [begin, end) as a number, returning false if the whole range
+    //! isn't one. Handles decimal, scientific, hexadecimal (including hex
+    //! floats), "0b" binary, inf and nan.
+    bool parseNumber(const char *begin, const char *end, double& out);
+    //! Parses [begin, end) as a float; see the double version.
+    bool parseNumber(const char *begin, const char *end, float& out);
+    //! Parses [begin, end) as a long double; see the double version.
+    bool parseNumber(const char *begin, const char *end, long double& out);
+    //! Big enough for any number written by formatNumber() or
+    //! formatShortest().
+    const size_t NUMBER_SIZE = 64;
+    //! Writes a number into s the way an ostream would by default, with six
+    //! significant digits. Returns its length.
+    size_t formatNumber(char *s, double v);
+    //! Writes a float; see the double version.
+    size_t formatNumber(char *s, float v);
+    //! Writes a long double; see the double version.
+    size_t formatNumber(char *s, long double v);
+    //! Writes the shortest form of a number that parses back to exactly the
+    //! same value into s. Returns its length.
+    size_t formatShortest(char *s, double v);
+    //! Writes a float; see the double version.
+    size_t formatShortest(char *s, float v);
+    //! Writes a long double; see the double version.
+    size_t formatShortest(char *s, long double v);
+    //! Finds a name in a table of built-ins sorted by name, returning NULL if
+    //! it isn't there.
+    template <class B>
+    const B* findBuiltin(const B* table, size_t count,
+                         const std::string& name)
+    {
+        size_t low = 0, high = count, middle;
+        int order;
+
+        while(low < high)
+        {
+            middle = low + (high - low) / 2;
+            order = name.compare(table[middle].name);
+            if(order == 0)
+                return &table[middle];
+            if(order > 0)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        return NULL;
+    }
+    //! Returns true if one name sorts before another, as std::string's
+    //! compare() orders them.
+    constexpr bool precedes(const char* a, const char* b)
+    {
+        return *a != *b ? (unsigned char)*a < (unsigned char)*b
+                        : *a && precedes(a + 1, b + 1);
+    }
+    //! Returns true if a table of built-ins is sorted by name, as
+    //! findBuiltin() needs; the tables check themselves with it when they
+    //! are compiled.
+    template <class B, size_t N>
+    constexpr bool sortedByName(const B (&table)[N], size_t i = 1)
+    {
+        return i >= N || (precedes(table[i - 1].name, table[i].name) &&
+                          sortedByName(table, i + 1));
+    }
     //! Portably prints a list of help items.
-    void printHelpItems(const HelpItems& items);
+    void printHelpItems(const HelpItem* items, size_t count);
+#ifdef RPN_COUNT_ALLOCATIONS
+    //! Returns how many heap allocations have been made so far.
+    unsigned long allocationCount();
+#endif
+
+    //! Prints a string.
+    inline void Print(const char* s)
+    {
+        Port::Write(s, std::strlen(s));
+    }
+
+    //! Prints a string.
+    inline void Print(const std::string& s)
+    {
+        Port::Write(s.data(), s.size());
+    }
+
+    //! Prints a character.
+    inline void Print(char c)
+    {
+        Port::Write(&c, 1);
+    }
+
+    //! Prints a number with six significant digits.
+    template <class T>
+    inline void PrintNumber(T v)
+    {
+        char s[NUMBER_SIZE];
+        Port::Write(s, formatNumber(s, v));
+    }
+
+    //! Prints a number with six significant digits.
+    inline void Print(float v)       { PrintNumber(v); }
+    //! Prints a number with six significant digits.
+    inline void Print(double v)      { PrintNumber(v); }
+    //! Prints a number with six significant digits.
+    inline void Print(long double v) { PrintNumber(v); }
+
+    //! Prints the shortest form of a number that reads back exactly.
+    template <class T>
+    inline void PrintShortest(T v)
+    {
+        char s[NUMBER_SIZE];
+        Port::Write(s, formatShortest(s, v));
+    }
+
+    //! Prints a number in fixed notation.
+    void PrintDetailed(float v);
+    //! Prints a number in fixed notation.
+    void PrintDetailed(double v);
+    //! Prints a number in fixed notation.
+    void PrintDetailed(long double v);
+
+    //! Prints an item with a function for printing each of its values.
+    //! Arrays are printed as "{ 1, 2, 3, }".
+    template <class T>
+    void PrintItem(const BasicItem<T>& item, void (*printer)(T));
 
     //! A portable way to print things.
     template <class T>
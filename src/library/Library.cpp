@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Library.cpp - the C interface of librpn.                                    *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Library.h"
+using namespace std;
+using namespace RPN;
+
+struct rpn_calculator
+{
+    BasicCalculator<double> calculator;
+
+    rpn_calculator() : calculator() {}
+};
+
+// returns an item's values.
+static size_t values(const BasicItem<double>& item, const double** values)
+{
+    *values = item.Data();
+    return item.Size();
+}
+
+rpn_calculator* rpn_create(void)
+{
+    return new rpn_calculator;
+}
+
+void rpn_destroy(rpn_calculator* calculator)
+{
+    delete calculator;
+}
+
+int rpn_eval(rpn_calculator* calculator, const char* line)
+{
+    if(calculator->calculator.Eval(line) == BasicCalculator<double>::Stopped)
+        return RPN_STOPPED;
+    return RPN_EVALUATED;
+}
+
+size_t rpn_stack_size(const rpn_calculator* calculator)
+{
+    return calculator->calculator.StackSize();
+}
+
+size_t rpn_item(const rpn_calculator* calculator, size_t depth,
+                const double** values)
+{
+    if(depth >= calculator->calculator.StackSize())
+        return 0;
+    return ::values(calculator->calculator.ItemAt(depth), values);
+}
+
+int rpn_variable(rpn_calculator* calculator, const char* name,
+                 const double** values, size_t* size)
+{
+    const BasicItem<double>* item = calculator->calculator.Variable(name);
+
+    if(!item)
+        return RPN_NOT_FOUND;
+    *size = ::values(*item, values);
+    return RPN_FOUND;
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Library.h - the C interface of librpn.                                      *
+ ******************************************************************************/
+
+#ifndef RPN_LIBRARY_H
+#define RPN_LIBRARY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! A calculator of doubles. Each is independent of the others, so different
+//! threads may use different calculators at the same time; one calculator
+//! must only be used by one thread at a time.
+typedef struct rpn_calculator rpn_calculator;
+
+//! What evaluating a line did.
+enum rpn_result
+{
+    //! The line was run and the calculator is still running.
+    RPN_EVALUATED,
+    //! The calculator has stopped, because of this line or an earlier one.
+    RPN_STOPPED
+};
+
+//! Creates a calculator with an empty stack.
+rpn_calculator* rpn_create(void);
+
+//! Destroys a calculator.
+void rpn_destroy(rpn_calculator* calculator);
+
+//! Evaluates a line, returning an rpn_result. Nothing is printed.
+int rpn_eval(rpn_calculator* calculator, const char* line);
+
+//! Returns the number of items on the stack.
+size_t rpn_stack_size(const rpn_calculator* calculator);
+
+//! Points values at the item depth places below the top of the stack,
+//! returning its number of values: 1 for a number, or the length of an
+//! array. Returns 0 if the stack isn't that deep or the item is an empty
+//! array. The values are good until the next call to rpn_eval().
+size_t rpn_item(const rpn_calculator* calculator, size_t depth,
+                const double** values);
+
+//! What looking up a variable found.
+enum rpn_lookup
+{
+    //! The variable is set.
+    RPN_FOUND,
+    //! The variable isn't set, or the calculator doesn't know the name.
+    RPN_NOT_FOUND
+};
+
+//! Like rpn_item(), but for a variable: points values at its values and sets
+//! size to their number, returning an rpn_lookup. Looking up a name doesn't
+//! add it to the calculator.
+int rpn_variable(rpn_calculator* calculator, const char* name,
+                 const double** values, size_t* size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
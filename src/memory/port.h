@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * port.h - the in-memory port.                                                *
+ ******************************************************************************/
+
+#ifndef DOXYGEN_SKIP
+#ifndef _MEMORY_PORT_H_
+#define _MEMORY_PORT_H_
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+namespace RPN
+{
+    // reads lines from a string loaded beforehand and writes into another
+    // that grows as needed, so that a host or a benchmark can drive the
+    // calculator without stdio. each thread has its own input and output.
+    class Port
+    {
+        static std::string& Input()
+        {
+            static thread_local std::string input;
+            return input;
+        }
+
+        //! Where the next line of input begins.
+        static size_t& Position()
+        {
+            static thread_local size_t position = 0;
+            return position;
+        }
+
+    public:
+
+        //! Replaces the input with a copy of a string, to be read a line at
+        //! a time.
+        static void Load(const std::string& input)
+        {
+            Input() = input;
+            Position() = 0;
+        }
+
+        //! Returns everything written so far, which the host may clear.
+        static std::string& Output()
+        {
+            static thread_local std::string output;
+            return output;
+        }
+
+        static bool CanRun()
+        {
+            return Position() < Input().size();
+        }
+
+        static std::string GetLine()
+        {
+            const std::string& input = Input();
+            size_t& position = Position();
+            size_t end = input.find('\n', position);
+            std::string ret;
+
+            if(end == std::string::npos)
+                end = input.size();
+            ret = input.substr(position, end - position);
+            position = end < input.size() ? end + 1 : end;
+
+            return ret;
+        }
+
+        static void Post()
+        {
+        }
+
+        static void Print(const char* str, ...)
+        {
+            std::string& output = Output();
+            size_t used = output.size();
+            char buffer[256];
+            va_list args;
+            int n;
+
+            va_start(args, str);
+            n = vsnprintf(buffer, sizeof(buffer), str, args);
+            va_end(args);
+
+            if(n < 0)
+                return;
+            if(n < (int)sizeof(buffer))
+                output.append(buffer, n);
+            else
+            {
+                output.resize(used + n + 1);
+                va_start(args, str);
+                vsnprintf(&output[used], n + 1, str, args);
+                va_end(args);
+                output.resize(used + n);
+            }
+        }
+
+        static void Write(const char* str, size_t n)
+        {
+            Output().append(str, n);
+        }
+
+        static void Setup()
+        {
+        }
+    };
+}
+
+#endif
+#endif
@@ -126,6 +126,19 @@ namespace RPN
             //pspDebugScreenPrintf(str);
         }
 
+        static void Write(const char* str, size_t n)
+        {
+            // print in pieces small enough for the output buffer.
+            while(n)
+            {
+                int piece = n < sizeof(output_buffer) - 1 ?
+                            n : sizeof(output_buffer) - 1;
+                Print("%.*s", piece, str);
+                str += piece;
+                n -= piece;
+            }
+        }
+
         static void Setup();
     };
 }
@@ -37,6 +37,10 @@
 #include "psp/port.h"
 #elif  RPN_WII
 #include "wii/port.h"
+#elif  RPN_LIBRARY
+#include "library/port.h"
+#elif  RPN_MEMORY
+#include "memory/port.h"
 #else
 #error Please choose a port to build.
 #endif
@@ -47,5 +51,8 @@
 #include "Calculator.h"
 #include "Command.h"
 #include "HelpItem.h"
+#include "Instruction.h"
+#include "Lexer.h"
+#include "Stack.h"
 
 #endif // _RPN_H_
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Allocations.cpp - tests that cached lines don't allocate.              *
+ ******************************************************************************/
+
+
+#include "../rpn.h"
+#include "../Lexer.h"
+#include "Test.h"
+#include <string>
+using namespace RPN;
+using namespace std;
+
+//! How many times a line is evaluated before its allocations are counted.
+//! By then its blocks have been compiled, which allocates once.
+static const unsigned WARMUP = 2 * BasicBlock<Value>::HOT;
+
+//! How many times a line is evaluated while its allocations are counted.
+static const unsigned RUNS = 1000;
+
+//! Returns how many allocations evaluating a line makes once it's cached.
+//! Each line leaves the stack as it found it.
+static unsigned long allocationsOf(const string& line)
+{
+    Calculator calculator;
+    unsigned long allocations;
+
+    for(unsigned i = 0; i < WARMUP; ++i)
+        calculator.Eval(line);
+
+    allocations = allocationCount();
+    for(unsigned i = 0; i < RUNS; ++i)
+        calculator.Eval(line);
+
+    return allocationCount() - allocations;
+}
+
+//! Returns how many allocations splitting a line into tokens makes.
+static unsigned long lexerAllocationsOf(const string& line)
+{
+    unsigned long allocations = allocationCount();
+    Lexer lexer(line);
+    Token tok;
+
+    while(lexer.Next(tok))
+        ;
+
+    return allocationCount() - allocations;
+}
+
+void RPN::Test::allocations()
+{
+    RPN_CHECK(lexerAllocationsOf("  1 2\t+ a_long_variable_name\n") == 0);
+
+    RPN_CHECK(allocationsOf("1 2 + pop") == 0);
+    RPN_CHECK(allocationsOf("2 a = a a * pop pop") == 0);
+    RPN_CHECK(allocationsOf("1 2 swap dup pop - pop") == 0);
+    RPN_CHECK(allocationsOf("3 4 5 clamp 2 ** sqrt pop") == 0);
+}
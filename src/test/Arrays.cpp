@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Arrays.cpp - tests operators on arrays.                                *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Test.h"
+using namespace RPN;
+
+//! Returns true if an item is an array of the given elements.
+static bool isArray(const Item& item, const Value* values, size_t n)
+{
+    if(!item.IsArray() || item.Size() != n)
+        return false;
+
+    for(size_t i = 0; i < n; ++i)
+        if(item.Data()[i] != values[i])
+            return false;
+
+    return true;
+}
+
+void RPN::Test::arrays()
+{
+    const Value sums[] = { 4, 6 };
+    const Value pair[] = { 1, 2 };
+    const Value triple[] = { 1, 2, 3 };
+    Calculator calculator, empty, clamped;
+
+    // arrays of the same length are combined element by element.
+    calculator.Eval("1 2 2 pack 3 4 2 pack +");
+    RPN_CHECK(calculator.StackSize() == 1);
+    RPN_CHECK(isArray(calculator.ItemAt(0), sums, 2));
+
+    // arrays of different lengths are left, and the operator is treated like
+    // a variable, as with too few operands: the unset + is set to the top.
+    calculator.ClearStack();
+    calculator.Eval("1 2 3 3 pack 1 2 2 pack +");
+    RPN_CHECK(calculator.StackSize() == 2);
+    RPN_CHECK(isArray(calculator.ItemAt(0), pair, 2));
+    RPN_CHECK(isArray(calculator.ItemAt(1), triple, 3));
+    RPN_CHECK(calculator.Variable("+") != NULL);
+    RPN_CHECK(isArray(*calculator.Variable("+"), pair, 2));
+
+    // now that + is set, it's pushed instead.
+    calculator.Eval("+");
+    RPN_CHECK(calculator.StackSize() == 3);
+
+    // an empty array doesn't match a longer one either.
+    empty.Eval("0 pack 1 2 3 3 pack +");
+    RPN_CHECK(empty.StackSize() == 2);
+    RPN_CHECK(isArray(empty.ItemAt(0), triple, 3));
+    RPN_CHECK(isArray(empty.ItemAt(1), NULL, 0));
+
+    clamped.Eval("0 pack 1 2 3 3 pack 5 clamp");
+    RPN_CHECK(clamped.StackSize() == 3);
+    RPN_CHECK(isArray(clamped.ItemAt(1), triple, 3));
+    RPN_CHECK(isArray(clamped.ItemAt(2), NULL, 0));
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Eval.cpp - tests evaluating programs at compile time.                  *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "../Eval.h"
+#include "Test.h"
+using namespace RPN;
+
+static_assert(evaluate("3 4 + 2 *") == 14, "literals");
+static_assert(evaluate("-1.5 2.5e1 +") == 23.5, "signs and exponents");
+static_assert(evaluate("") == 0, "an empty program");
+static_assert(evaluate("w h *", {3.0, 4.0}) == 12, "variables");
+static_assert(evaluate("a b a - *", {3.0, 4.0}) == 3, "repeated variables");
+static_assert(evaluate<float>("1.5 2 *") == 3.0f, "floats");
+
+// exponents past the exact powers of ten, and ones past the range of T.
+static_assert(evaluate("1e22") == 1e22, "the last exact power");
+static_assert(evaluate("1e23") == 1e23, "an exact power once scaled");
+static_assert(evaluate("1e256") == 1e256, "an exponent of 256");
+static_assert(evaluate("1e300") == 1e300, "an exponent of 300");
+static_assert(evaluate("1e-300") == 1e-300, "a negative exponent");
+static_assert(evaluate("1e309") == std::numeric_limits<double>::infinity(),
+              "overflow");
+static_assert(evaluate("1e-400") == 0, "underflow");
+static_assert(evaluate("1e99999999999") ==
+              std::numeric_limits<double>::infinity(), "a long exponent");
+
+//! Doubles whose rounding the calculator's parser and Eval.h agree on.
+static const char* const NUMBERS[] =
+{
+    "0.1", "3.14159", "1e23", "1e-23", "9007199254740993", "2.5e-5",
+    "123456789012345678", "1.7976931348623157e308"
+};
+
+void RPN::Test::eval()
+{
+    BasicCalculator<double> calculator;
+    double value;
+
+    for(size_t i = 0; i < sizeof(NUMBERS) / sizeof(*NUMBERS); ++i)
+    {
+        RPN_CHECK(Constant::parseNumber(NUMBERS[i], value));
+        calculator.Eval(NUMBERS[i]);
+        RPN_CHECK(calculator.TopmostItem().Scalar() == value);
+    }
+
+    RPN_CHECK(!Constant::parseNumber("1e", value));
+    RPN_CHECK(!Constant::parseNumber("1.5x", value));
+}
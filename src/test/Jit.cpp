@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Jit.cpp - tests compiled blocks against the interpreter.               *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Test.h"
+#include <cstring>
+#include <vector>
+using namespace RPN;
+using namespace std;
+
+//! How many random blocks are run both ways for each type.
+static const unsigned BLOCKS = 5000;
+
+//! The most steps a random block has.
+static const unsigned MAX_STEPS = 48;
+
+//! How many literals a deep block starts with, which is more than there are
+//! machine registers to hold them.
+static const unsigned DEEP = 24;
+
+//! The numbers that literals and operands are drawn from: both zeros, signs,
+//! fractions, and large and tiny magnitudes.
+static const double NUMBERS[] =
+{
+    0, -0.0, 1, -1, 2, 0.5, -2.25, 3.75, 10, 0.1, 1e3, -1e-3, 1e30, -1e-30
+};
+
+//! Returns the next number of a fixed sequence, so that a failure can be
+//! reproduced.
+static unsigned long random(unsigned long& state)
+{
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return state >> 33;
+}
+
+//! Returns one of NUMBERS at random.
+template <class T>
+static T randomNumber(unsigned long& state)
+{
+    return (T)NUMBERS[random(state) % (sizeof(NUMBERS) / sizeof(*NUMBERS))];
+}
+
+//! Runs random blocks of every operator through the interpreter and as
+//! machine code, checking that both leave exactly the same bits.
+template <class T>
+static void compareEngines()
+{
+    typedef BasicCalculator<T>                      Calculator;
+    typedef typename Calculator::BuiltinOperator    BuiltinOperator;
+    typedef typename Calculator::Operation          Operation;
+    const BuiltinOperator* tables[2];
+    size_t counts[2];
+    vector<Operation> operations;
+    unsigned long state = 1;
+    unsigned compiled = 0;
+
+    // % traps on a zero divisor, which random operands soon give it, so it's
+    // left out.
+    tables[0] = Calculator::builtinOperators(counts[0]);
+    tables[1] = Calculator::derivedOperators(counts[1]);
+    for(size_t i = 0; i < 2; ++i)
+        for(size_t j = 0; j < counts[i]; ++j)
+        {
+            const BuiltinOperator& op = tables[i][j];
+            if(!strcmp(op.name, "%"))
+                continue;
+            operations.push_back(Operation(op.arity, op.pure, op.unary,
+                                           op.binary, op.ternary,
+                                           op.kernel));
+        }
+
+    for(unsigned i = 0; i < BLOCKS; ++i)
+    {
+        BasicBlock<T> block;
+        unsigned steps = 1 + random(state) % MAX_STEPS;
+        vector<T> interpreted, native;
+        NativeCode code;
+
+        if(i % 8 == 0)
+            for(unsigned j = 0; j < DEEP; ++j)
+                block.Push(randomNumber<T>(state));
+
+        for(unsigned j = 0; j < steps; ++j)
+            if(random(state) % 3 == 0)
+                block.Push(randomNumber<T>(state));
+            else
+                block.Apply(operations[random(state) % operations.size()]);
+
+        // the operands taken from the stack start at registers[1].
+        interpreted.resize(block.Registers());
+        for(size_t j = 1; j <= block.Need(); ++j)
+            interpreted[j] = randomNumber<T>(state);
+        native = interpreted;
+
+        // a new block is interpreted the first time it's run.
+        block.Run(&interpreted[0]);
+
+        code = NativeCode::Compile(block);
+        if(code.Empty())
+            continue;
+        code(&native[0]);
+        ++compiled;
+
+        RPN_CHECK(!memcmp(&interpreted[1], &native[1],
+                          block.Results() * sizeof(T)));
+    }
+
+#ifdef RPN_JIT
+    RPN_CHECK(compiled == BLOCKS);
+#else
+    (void)compiled;
+#endif
+}
+
+void RPN::Test::jit()
+{
+    compareEngines<float>();
+    compareEngines<double>();
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Library.cpp - tests the C interface of librpn.                         *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "../library/Library.h"
+#include "Test.h"
+#include <cstdio>
+using namespace RPN;
+
+//! How many names that aren't variables are looked up.
+static const unsigned UNKNOWN_NAMES = 1000;
+
+void RPN::Test::library()
+{
+    rpn_calculator* calculator = rpn_create();
+    const double* values = NULL;
+    size_t size = 0;
+    unsigned long allocations;
+    char name[16];
+
+    RPN_CHECK(rpn_eval(calculator, "2 3 +") == RPN_EVALUATED);
+    RPN_CHECK(rpn_stack_size(calculator) == 1);
+    RPN_CHECK(rpn_item(calculator, 0, &values) == 1 && values[0] == 5);
+    RPN_CHECK(rpn_item(calculator, 1, &values) == 0);
+
+    // variables are set by lines and read back without evaluating anything.
+    RPN_CHECK(rpn_eval(calculator, "7 a 1 2 2 pack b") == RPN_EVALUATED);
+    RPN_CHECK(rpn_variable(calculator, "a", &values, &size) == RPN_FOUND);
+    RPN_CHECK(size == 1 && values[0] == 7);
+    RPN_CHECK(rpn_variable(calculator, "b", &values, &size) == RPN_FOUND);
+    RPN_CHECK(size == 2 && values[0] == 1 && values[1] == 2);
+    RPN_CHECK(rpn_variable(calculator, "PI", &values, &size) == RPN_FOUND);
+    RPN_CHECK(size == 1 && values[0] > 3.14 && values[0] < 3.15);
+
+    // names the calculator hasn't seen aren't added to it, so looking up
+    // any number of them doesn't allocate.
+    allocations = allocationCount();
+    for(unsigned i = 0; i < UNKNOWN_NAMES; ++i)
+    {
+        snprintf(name, sizeof(name), "c%u", i);
+        RPN_CHECK(rpn_variable(calculator, name, &values, &size) ==
+                  RPN_NOT_FOUND);
+    }
+    RPN_CHECK(allocationCount() == allocations);
+
+    // once stopped, a calculator stays stopped.
+    RPN_CHECK(rpn_eval(calculator, "x") == RPN_STOPPED);
+    RPN_CHECK(rpn_eval(calculator, "1") == RPN_STOPPED);
+
+    rpn_destroy(calculator);
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Optimizer.cpp - tests that optimized lines give the same results.      *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "../Lexer.h"
+#include "Test.h"
+#include <string>
+using namespace RPN;
+using namespace std;
+
+//! A line to run after another that sets up the stack and variables.
+struct Case
+{
+    const char* setup;
+    const char* line;
+};
+
+//! Returns true if two items are the same scalar, or arrays of the same
+//! elements.
+static bool sameItem(const Item& a, const Item& b)
+{
+    if(a.IsArray() != b.IsArray() || a.Size() != b.Size())
+        return false;
+
+    for(size_t i = 0; i < a.Size(); ++i)
+        if(a.Data()[i] != b.Data()[i])
+            return false;
+
+    return true;
+}
+
+//! Returns true if the line gives the same stack when it's compiled as a
+//! whole as when each of its tokens is run as a line of its own, which
+//! leaves the optimizer nothing to do.
+static bool sameResults(const Case& c)
+{
+    Calculator whole, tokens;
+    string line = c.line;
+    Lexer lexer(line);
+    Token tok;
+
+    whole.Eval(c.setup);
+    tokens.Eval(c.setup);
+
+    whole.Eval(line);
+    while(lexer.Next(tok))
+        tokens.Eval(tok.Str());
+
+    if(whole.StackSize() != tokens.StackSize())
+        return false;
+
+    for(size_t i = 0; i < whole.StackSize(); ++i)
+        if(!sameItem(whole.ItemAt(i), tokens.ItemAt(i)))
+            return false;
+
+    return true;
+}
+
+void RPN::Test::optimizer()
+{
+    static const Case cases[] =
+    {
+        // u and v are arrays of different lengths, so * acts as a variable,
+        // and a repeated u v * doesn't give the same value twice.
+        { "1 2 3 3 pack u pop 1 2 2 pack v pop", "u v * u v *"           },
+        { "1 2 3 3 pack u pop 1 2 2 pack v pop", "u v + 2 * u v + 2 *"   },
+        { "1 2 3 3 pack u pop",                  "u u * u u * +"         },
+        { "1 2 2 pack 1 2 3 3 pack",             "z 2 * z 2 * +"         },
+        { "1 2 2 pack",                          "w w + 3 ** w w + 3 **" },
+
+        // expressions of scalars can still be shared.
+        { "",                                    "3 a a a * a a * +"     },
+        { "2 b",                                 "c c b * c b * +"       },
+        { "5",                                   "d d 1 + d 1 + *"       }
+    };
+
+    for(size_t i = 0; i < sizeof(cases) / sizeof(*cases); ++i)
+        RPN_CHECK(sameResults(cases[i]));
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Reset.cpp - tests putting a calculator back the way it was made.       *
+ ******************************************************************************/
+
+#include "../rpn.h"
+#include "Test.h"
+using namespace RPN;
+
+void RPN::Test::reset()
+{
+    Calculator calculator;
+
+    // a line compiled while a is set has its value folded in, so it mustn't
+    // be run again once Reset() has unset a.
+    calculator.Eval("2 a");
+    calculator.Eval("a 3 *");
+    RPN_CHECK(calculator.TopmostItem().Scalar() == 6);
+
+    calculator.Reset();
+    RPN_CHECK(calculator.StackSize() == 0);
+    RPN_CHECK(calculator.Variable("a") == NULL);
+
+    calculator.Eval("5 a");
+    calculator.Eval("a 3 *");
+    RPN_CHECK(calculator.TopmostItem().Scalar() == 15);
+
+    // the predefined variables are put back as well.
+    calculator.Eval("unset PI");
+    calculator.Reset();
+    RPN_CHECK(calculator.Variable("PI") != NULL);
+}
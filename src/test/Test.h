@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Reverse Polish Notation calculator.                                         *
+ * Copyright (c) 2007-2009, Samuel Fredrickson <kinghajj@gmail.com>            *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * Redistribution and use in source and binary forms, with or without          *
+ * modification, are permitted provided that the following conditions are met: *
+ *     * Redistributions of source code must retain the above copyright        *
+ *       notice, this list of conditions and the following disclaimer.         *
+ *     * Redistributions in binary form must reproduce the above copyright     *
+ *       notice, this list of conditions and the following disclaimer in the   *
+ *       documentation and/or other materials provided with the distribution.  *
+ *                                                                             *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS *
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED           *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY        *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES  *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR          *
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER  *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT          *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY   *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH *
+ * DAMAGE.                                                                     *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * test/Test.h - the test harness.                                             *
+ ******************************************************************************/
+
+#ifndef RPN_TEST_H
+#define RPN_TEST_H
+
+//! Checks that an expression is true, counting a failure if it isn't.
+#define RPN_CHECK(expression) \
+    ((expression) ? (void)0 : \
+     RPN::Test::fail(__FILE__, __LINE__, #expression))
+
+namespace RPN
+{
+    namespace Test
+    {
+        //! Reports a check that failed.
+        void fail(const char* file, int line, const char* expression);
+
+        //! Tests that evaluating cached lines doesn't allocate.
+        void allocations();
+        //! Tests operators on arrays.
+        void arrays();
+        //! Tests evaluating programs at compile time.
+        void eval();
+        //! Tests that compiled blocks give exactly the interpreter's results.
+        void jit();
+        //! Tests the C interface of librpn.
+        void library();
+        //! Tests that optimized lines give the same results.
+        void optimizer();
+        //! Tests putting a calculator back the way it was made.
+        void reset();
+    }
+}
+
+#endif
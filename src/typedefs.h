@@ -31,6 +31,7 @@
 #ifndef RPN_TYPEDEFS_H
 #define RPN_TYPEDEFS_H
 
+#include <cstddef>
 #include <list>
 #include <map>
 #include <string>
@@ -42,40 +43,46 @@ namespace RPN
     // FORWARD DECLARATIONS                                                   //
     ////////////////////////////////////////////////////////////////////////////
 
-    class Calculator;
-    class Command;
-    class HelpItem;
+    template <class T> class BasicBlock;
+    template <class T> class BasicCalculator;
+    template <class T> class BasicCommand;
+    struct HelpItem;
+    template <class T> class BasicInstruction;
+    template <class T> class BasicItem;
+    template <class T> class BasicOperation;
+    template <class T> class BasicStack;
 
     ////////////////////////////////////////////////////////////////////////////
     // TYPEDEFS                                                               //
     ////////////////////////////////////////////////////////////////////////////
 
 #ifdef RPN_DOUBLE
-    //! The type operated on by the calculator.
+    //! The type operated on by the calculator unless another is chosen when
+    //! the program starts.
     typedef double Value;
 #elif  RPN_LONG_DOUBLE
-    //! The type operated on by the calculator.
+    //! The type operated on by the calculator unless another is chosen when
+    //! the program starts.
     typedef long double Value;
 #else
 #error Please choose either RPN_DOUBLE or RPN_LONG_DOUBLE.
 #endif
-    //! The type of an operator function.
-    typedef Value (*Operator)(Value a, Value b);
-    //! The type of a collection of commands.
-    typedef std::map<std::string, Command>   Commands;
-    //! The type of a collection of operators.
-    typedef std::map<std::string, Operator>  Operators;
-    //! The type of a collection of variables.
-    typedef std::map<std::string, Value>     Variables;
-    //! The type of the stack used by the calculator.
-    typedef std::list<Value>                 Stack;
-    //! The type of the history stack used by the calculator.
-    typedef std::list<Stack>                 History;
-    //! The type of a command member function. All commands must be members
-    //! of the Calculator class.
-    typedef void (Calculator::*CommandPtr)(std::vector<std::string>&);
-    //! A list of help items.
-    typedef std::list<HelpItem> HelpItems;
+    //! A calculator of the default type.
+    typedef BasicCalculator<Value>  Calculator;
+    //! A command of the default type.
+    typedef BasicCommand<Value>     Command;
+    //! An instruction of the default type.
+    typedef BasicInstruction<Value> Instruction;
+    //! An item of the default type.
+    typedef BasicItem<Value>        Item;
+    //! An operation of the default type.
+    typedef BasicOperation<Value>   Operation;
+    //! A stack of the default type.
+    typedef BasicStack<Value>       Stack;
 }
 
+//! Expands a macro once for each type a calculator can operate on, to
+//! instantiate the templates defined in a source file.
+#define RPN_FOR_EACH_TYPE(M) M(float) M(double) M(long double)
+
 #endif
@@ -38,6 +38,8 @@ extern "C" {
 #include <fat.h>
 }
 
+#include <cstdarg>
+#include <cstdio>
 #include <string>
 
 namespace RPN
@@ -85,6 +87,11 @@ namespace RPN
             va_end(args);
         }
 
+        static void Write(const char* str, size_t n)
+        {
+            fwrite(str, 1, n, stdout);
+        }
+
         static void Setup()
         {
             InitConsole();